@@ -14,11 +14,28 @@
 #include <iosfwd>
 #include <functional>
 #include <optional>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #ifdef _MSC_VER
 #include <malloc.h>
 #endif
 
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+extern "C" __declspec(dllimport) void __stdcall FlushProcessWriteBuffers();
+#endif
+
 #define OMNI_ERROR_PTR_ERROR_COPY_CONVERT_OWNING \
     "Can only use copying conversion functions with non-owning omni_ptrs. " \
     "(did you mean to use std::move or omni_view/omni_ref?)"
@@ -26,6 +43,16 @@
 #define OMNI_ERROR_BOUNDED_MAKE_OMNI \
     "Cannot use make_omni with bounded array types (T[N])"
 
+// Keeps rarely taken paths out of line, so the paths that are inlined everywhere stay small.
+// tests/codegen checks the resulting instruction counts.
+#if defined(__GNUC__) || defined(__clang__)
+    #define OMNI_COLD [[gnu::noinline, gnu::cold]]
+#elif defined(_MSC_VER)
+    #define OMNI_COLD __declspec(noinline)
+#else
+    #define OMNI_COLD
+#endif
+
 namespace DxPtr {
     namespace detail {
         template<typename T, typename... Args>
@@ -40,7 +67,25 @@ namespace DxPtr {
             return toRound + multiple - remainder;
         }
 
+        // The value of std::hardware_destructive_interference_size may change with -mtune,
+        // which GCC warns about. We only use it for padding, never across an ABI boundary.
+        #ifdef __cpp_lib_hardware_interference_size
+            #if defined(__GNUC__) && !defined(__clang__)
+            #pragma GCC diagnostic push
+            #pragma GCC diagnostic ignored "-Winterference-size"
+            #endif
+            inline constexpr std::size_t cache_line_size = std::hardware_destructive_interference_size;
+            #if defined(__GNUC__) && !defined(__clang__)
+            #pragma GCC diagnostic pop
+            #endif
+        #else
+            inline constexpr std::size_t cache_line_size = 64;
+        #endif
+
         inline void* aligned_alloc(std::align_val_t alignment, std::size_t size) {
+            // std::aligned_alloc requires size to be a multiple of the alignment
+            size = round_up_to_nearest_multiple(size, static_cast<std::size_t>(alignment));
+
             #if defined(_MSVC_VER) || defined(_MSVC_STL_VERSION)
                 #ifdef _DEBUG
                     return _aligned_malloc_dbg(size, static_cast<std::size_t>(alignment), __FILE__, __LINE__);
@@ -63,6 +108,23 @@ namespace DxPtr {
                 std::free(ptr);
             #endif
         }
+
+        // Default source of conjoined buffers.
+        // Any Allocator given to omni_block provides this same pair of functions.
+        struct aligned_allocator {
+            void* allocate(std::align_val_t alignment, std::size_t size) {
+                void* buffer = aligned_alloc(alignment, size);
+
+                if (buffer == nullptr)
+                    throw std::bad_alloc();
+
+                return buffer;
+            }
+
+            void deallocate(void* buffer, std::align_val_t, std::size_t) noexcept {
+                aligned_free(buffer);
+            }
+        };
     }
 
     namespace AlignmentPolicy {
@@ -76,9 +138,7 @@ namespace DxPtr {
             constexpr Default() = default;
 
             template<typename T>
-            constexpr std::align_val_t get_alignment() const {
-                return static_cast<std::align_val_t>(alignof(T));
-            }
+            constexpr std::align_val_t get_alignment() const;
         };
 
         template<std::size_t Alignment>
@@ -93,6 +153,59 @@ namespace DxPtr {
             }
         };
 
+        // Keeps the stored object on cache lines of its own, so that reference count
+        // traffic on the control block from other threads does not invalidate lines
+        // the owner is writing in T
+        class CacheIsolated {
+            public:
+            constexpr CacheIsolated() = default;
+
+            static constexpr bool isolates_control = true;
+
+            template<typename T>
+            constexpr std::align_val_t get_alignment() const {
+                return static_cast<std::align_val_t>(std::max(alignof(T), detail::cache_line_size));
+            }
+        };
+
+        // Specialize to true to make the Default policy cache isolate a hot type.
+        // Arrays of it are isolated as a whole, their elements are not padded apart.
+        template<typename T>
+        inline constexpr bool isolate = false;
+
+        template<typename T>
+        constexpr std::align_val_t Default::get_alignment() const {
+            if constexpr (isolate<std::remove_cv_t<std::remove_extent_t<T>>>)
+                return CacheIsolated{}.template get_alignment<T>();
+            else
+                return static_cast<std::align_val_t>(alignof(T));
+        }
+
+        template<typename T, typename Policy>
+        constexpr bool is_cache_isolated() {
+            using Stored = std::remove_cv_t<std::remove_extent_t<T>>;
+
+            if constexpr (requires { Policy::isolates_control; })
+                return Policy::isolates_control;
+            else if constexpr (std::is_same_v<Policy, Default>)
+                return isolate<Stored>;
+            else
+                return false;
+        }
+
+        // Distance between array elements. Cache isolation only pads the array as a whole,
+        // so elements of isolating policies sit at their natural stride.
+        template<typename E, typename Policy>
+        constexpr std::size_t get_element_stride() {
+            if constexpr (std::is_same_v<Policy, Default> or std::is_same_v<Policy, CacheIsolated>)
+                return sizeof(E);
+            else
+                return detail::round_up_to_nearest_multiple(
+                      sizeof(E)
+                    , static_cast<std::size_t>(Policy{}.template get_alignment<E>())
+                );
+        }
+
         template<typename T, typename Policy>
         requires interface<T, Policy>
         constexpr std::size_t get_stored_size() = delete;
@@ -103,10 +216,7 @@ namespace DxPtr {
             using namespace detail;
 
             if constexpr (std::is_bounded_array_v<T>)
-                return std::extent_v<T> * round_up_to_nearest_multiple(
-                      sizeof(std::remove_extent_t<T>)
-                    , Policy{}.template get_alignment<std::remove_extent_t<T>>()
-                );
+                return std::extent_v<T> * get_element_stride<std::remove_extent_t<T>, Policy>();
             else
                 return sizeof(T);
         }
@@ -114,11 +224,7 @@ namespace DxPtr {
         template<typename T, typename Policy>
         requires interface<T, Policy> and std::is_unbounded_array_v<T>
         constexpr std::size_t get_stored_size(std::size_t num) {
-            using namespace detail;
-            return num * round_up_to_nearest_multiple(
-                  sizeof(std::remove_extent_t<T>)
-                , static_cast<std::size_t>(Policy{}.template get_alignment<std::remove_extent_t<T>>())
-            );
+            return num * get_element_stride<std::remove_extent_t<T>, Policy>();
         }
     }
 
@@ -129,49 +235,515 @@ namespace DxPtr {
     requires DxPtr::detail::correct_constructor_args<T, Args...>
     omni_ptr<T, AP> make_omni(Args&&... args);
 
+    // Specialize to true for types forming deep owner graphs, such as lists and trees.
+    // Owners of such types nested inside one being destroyed are queued on a
+    // thread-local worklist and destroyed one after another instead of recursively.
+    template<typename T>
+    inline constexpr bool iterative_teardown = false;
+
+    // Specialize to true for types made with make_omni_lazy. Owners and views of such types
+    // check whether the object still has to be constructed whenever they are dereferenced,
+    // which other types never pay for.
+    template<typename T>
+    inline constexpr bool lazy_construction = false;
+
     namespace detail { 
+        class omni_block_base;
+
+        // Barrier pair ordering a thread's own frequent operations against rare ones from
+        // other threads. The light side only stops the compiler from reordering, while the
+        // heavy side forces a full barrier on every thread of the process that is running.
+        #if defined(__linux__) || defined(_WIN32)
+            inline constexpr bool has_heavy_barrier = true;
+        #else
+            inline constexpr bool has_heavy_barrier = false;
+        #endif
+
+        inline void light_barrier() noexcept {
+            if constexpr (has_heavy_barrier)
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            else
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        inline void heavy_barrier() noexcept {
+            #if defined(__linux__)
+                // Registration is process wide, so it is only attempted once
+                static const bool expedited = syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+
+                if (expedited and syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0)
+                    return;
+
+                // Without membarrier, changing the protection of a page in use makes the
+                // kernel interrupt every CPU running this process to flush its TLB
+                static std::mutex pageMutex;
+                static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+                static void* const page = mmap(nullptr, pageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (page == MAP_FAILED)
+                    std::terminate();
+
+                std::scoped_lock lock(pageMutex);
+
+                mprotect(page, pageSize, PROT_READ | PROT_WRITE);
+                *static_cast<volatile char*>(page) = 0;
+                mprotect(page, pageSize, PROT_READ);
+            #elif defined(_WIN32)
+                FlushProcessWriteBuffers();
+            #else
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            #endif
+        }
+
+        // Per-thread state for biased reference counting.
+        // Blocks name their owner thread by the address of its state. The state stays
+        // allocated until the thread has exited and every block biased to it gave up the
+        // bias, so a new thread can never be mistaken for the owner of an older block.
+        class biased_thread {
+            // Block whose local count this thread is updating, for hand-offs to wait on
+            std::atomic<const omni_block_base*> active = nullptr;
+
+            // Blocks created by the thread, only counted by the thread itself. Once it
+            // exits, balance reaches zero when the last of them gave up its bias.
+            std::int64_t created = 0;
+            std::atomic<std::int64_t> balance = 0;
+            std::atomic<bool> exited = false;
+
+            // Ids are never reused, unlike addresses
+            std::uint64_t id;
+
+            static inline std::atomic<std::uint64_t> nextId = 1;
+
+            // 0 until the thread first creates a control block, and again once it exits
+            static inline thread_local std::uintptr_t currentAddress = 0;
+            static inline thread_local std::uint64_t currentId = 0;
+
+            biased_thread() : id(nextId.fetch_add(1, std::memory_order_relaxed)) { }
+
+            // The thread's own hold on its state, dropped when it exits
+            class registration {
+                biased_thread* state = new biased_thread();
+
+                public:
+                registration() noexcept {
+                    currentAddress = reinterpret_cast<std::uintptr_t>(state);
+                    currentId = state->id;
+                }
+
+                // Blocks still biased to the thread keep their local counts as they are,
+                // whoever expires their owner later folds them in
+                ~registration() {
+                    currentAddress = 0;
+                    state->exited.store(true, std::memory_order_release);
+
+                    if (state->balance.fetch_add(state->created, std::memory_order_acq_rel) + state->created == 0)
+                        delete state;
+                }
+
+                registration(const registration&) = delete;
+                registration& operator=(const registration&) = delete;
+
+                biased_thread& get() noexcept { return *state; }
+            };
+
+            static biased_thread& current() {
+                thread_local registration self;
+                return self.get();
+            }
+
+            static biased_thread* from_address(std::uintptr_t address) noexcept {
+                return reinterpret_cast<biased_thread*>(address);
+            }
+
+            public:
+            biased_thread(const biased_thread&) = delete;
+            biased_thread& operator=(const biased_thread&) = delete;
+
+            static std::uint64_t current_id() noexcept {
+                return currentId;
+            }
+
+            static std::uintptr_t current_address() noexcept {
+                return currentAddress;
+            }
+
+            static std::uint64_t acquire_current_id() {
+                return current().id;
+            }
+
+            // Registers the calling thread if needed and counts a block biased to it
+            static std::uintptr_t acquire_for_block() {
+                biased_thread& state = current();
+                state.created++;
+
+                return reinterpret_cast<std::uintptr_t>(&state);
+            }
+
+            // Brackets the owner thread's update of a local count
+            static void begin_local(std::uintptr_t self, const omni_block_base* block) noexcept {
+                from_address(self)->active.store(block, std::memory_order_release);
+                light_barrier();
+            }
+
+            static void end_local(std::uintptr_t self) noexcept {
+                from_address(self)->active.store(nullptr, std::memory_order_release);
+            }
+
+            // Called by another thread after taking the bias of block away from owner.
+            // Returns once the owner can no longer be updating its local count.
+            static void quiesce(std::uintptr_t owner, const omni_block_base* block) noexcept {
+                biased_thread* state = from_address(owner);
+
+                if (state->exited.load(std::memory_order_acquire))
+                    return;
+
+                heavy_barrier();
+
+                while (state->active.load(std::memory_order_acquire) == block)
+                    std::this_thread::yield();
+            }
+
+            // A block biased to owner gave up its bias
+            static void drop_bias(std::uintptr_t owner) noexcept {
+                biased_thread* state = from_address(owner);
+
+                // Negative while the thread lives, so only reaches zero after it exits
+                if (state->balance.fetch_sub(1, std::memory_order_acq_rel) - 1 == 0)
+                    delete state;
+            }
+        };
+
+        // Reference counts are biased towards the thread that created the block.
+        // That thread updates a non-atomic local count, every other thread updates an atomic
+        // shared count, which may go negative meanwhile. The owner's own reference is always
+        // in the local count, so the block cannot be freed before its owner expires it.
+        // Expiry gives up the bias on whichever thread it happens, folding the local count
+        // into the shared one. From then on the block is an ordinary atomically counted one,
+        // and whichever thread drops the last reference frees it.
         class omni_block_base {
+            // Shared count is stored as (count << 1 | merged) so that the flag and count
+            // change together in one atomic operation
+            static constexpr std::int64_t merged_flag = 1;
+            static constexpr std::int64_t shared_one = 2;
+
+            // Never the address of a thread's state, nor 0 as seen by unregistered threads
+            static constexpr std::uintptr_t no_owner = ~std::uintptr_t(0);
+
             protected:
             uintptr_t originalPointer;
-            std::size_t refCount = 1;
-            bool isExpired = false;
+
+            private:
+            std::atomic<std::uintptr_t> ownerThread;
+
+            // Only modified by the owner thread. Atomic solely so use_count() may read it
+            // from elsewhere, owner updates are plain loads and stores.
+            std::atomic<std::size_t> localCount = 1;
+            std::atomic<std::int64_t> sharedCount = 0;
+
+            static constexpr std::uint8_t expired_flag = 1;
+            static constexpr std::uint8_t waiting_flag = 2;
+
+            // Set while a lazily made object is not constructed yet, and while it is being constructed
+            static constexpr std::uint8_t pending_flag = 4;
+            static constexpr std::uint8_t building_flag = 8;
+
+            // The waiting flag is only set by wait_expired(), so expiry skips the notify
+            // unless some thread is actually blocked on this block
+            std::atomic<std::uint8_t> expiry = 0;
+
+            #ifndef NDEBUG
+            // Live omni_borrows of the stored object, only tracked in debug builds
+            std::atomic<std::size_t> borrowCount = 0;
+            #endif
+
+            // Checked before the stored object is destroyed, while a borrow could still read it
+            void assert_unborrowed() noexcept {
+                #ifndef NDEBUG
+                assert(borrowCount.load(std::memory_order_acquire) == 0 and "omni owner expired while borrowed");
+                #endif
+            }
+
+            void publish_expiry() noexcept {
+                if (expiry.fetch_or(expired_flag, std::memory_order_acq_rel) & waiting_flag)
+                    notify_expiry();
+            }
+
+            OMNI_COLD void notify_expiry() noexcept {
+                expiry.notify_all();
+            }
+
+            // One thread constructs, the rest wait for it. If construction throws,
+            // the object stays pending and the next access tries again.
+            void materialize_slow() {
+                std::uint8_t state = expiry.load(std::memory_order_acquire);
+
+                while (state & pending_flag) {
+                    if (state & building_flag) {
+                        expiry.wait(state, std::memory_order_acquire);
+                        state = expiry.load(std::memory_order_acquire);
+                        continue;
+                    }
+
+                    if (not expiry.compare_exchange_weak(state, state | building_flag, std::memory_order_acq_rel, std::memory_order_acquire))
+                        continue;
+
+                    try {
+                        materialize();
+                    } catch (...) {
+                        expiry.fetch_and(static_cast<std::uint8_t>(~building_flag), std::memory_order_release);
+                        expiry.notify_all();
+                        throw;
+                    }
+
+                    expiry.fetch_and(static_cast<std::uint8_t>(~(pending_flag | building_flag)), std::memory_order_release);
+                    expiry.notify_all();
+                    return;
+                }
+            }
 
             public:
-            omni_block_base(uintptr_t original) : originalPointer(original) { }
+            omni_block_base(uintptr_t original) 
+            : originalPointer(original), ownerThread(biased_thread::acquire_for_block()) { }
             
             protected:
-            virtual ~omni_block_base() noexcept = default;
+            // Only still biased if the block is freed without ever being owned
+            virtual ~omni_block_base() noexcept {
+                std::uintptr_t owner = ownerThread.load(std::memory_order_relaxed);
+
+                if (owner != no_owner)
+                    biased_thread::drop_bias(owner);
+            }
+
+            // For blocks whose stored object is constructed on first access,
+            // or destroyed to be reconstructed on the next one
+            void mark_pending() noexcept {
+                expiry.fetch_or(pending_flag, std::memory_order_release);
+            }
+
+            // For pending blocks expired before anything constructed the object
+            void clear_pending() noexcept {
+                expiry.fetch_and(static_cast<std::uint8_t>(~pending_flag), std::memory_order_release);
+            }
+
+            // Constructs the stored object of a pending block
+            virtual void materialize() { }
+
+            private:
+            // Runs update if the calling thread owns the bias, returning whether it did.
+            // The owner announces the block before checking again, so that a concurrent
+            // hand-off either waits for the update or is seen by the check.
+            template<typename Update>
+            bool update_local(Update update) noexcept {
+                std::uintptr_t self = biased_thread::current_address();
+
+                if (ownerThread.load(std::memory_order_relaxed) != self)
+                    return false;
+
+                biased_thread::begin_local(self, this);
+
+                bool owned = ownerThread.load(std::memory_order_relaxed) == self;
+
+                if (owned)
+                    update();
+
+                biased_thread::end_local(self);
+
+                return owned;
+            }
+
+            // Whoever took the bias away from owner adds its frozen local count
+            void fold(std::uintptr_t owner, std::int64_t local) noexcept {
+                std::int64_t delta = local * shared_one + merged_flag;
+
+                biased_thread::drop_bias(owner);
+
+                if (sharedCount.fetch_add(delta, std::memory_order_acq_rel) + delta == merged_flag)
+                    delete this;
+            }
+
+            OMNI_COLD void hand_off(std::uintptr_t owner) noexcept {
+                if (not ownerThread.compare_exchange_strong(owner, no_owner, std::memory_order_acq_rel, std::memory_order_relaxed))
+                    return;
+
+                biased_thread::quiesce(owner, this);
+                fold(owner, static_cast<std::int64_t>(localCount.load(std::memory_order_relaxed)));
+            }
+
+            void shared_decrement() noexcept {
+                if (sharedCount.fetch_sub(shared_one, std::memory_order_acq_rel) - shared_one == merged_flag)
+                    delete this;
+            }
+
+            // Owner thread dropped its last local reference
+            void merge_local() noexcept {
+                std::uintptr_t owner = biased_thread::current_address();
+
+                // Lost to a hand-off, which folded the count instead
+                if (ownerThread.compare_exchange_strong(owner, no_owner, std::memory_order_relaxed))
+                    fold(owner, 0);
+            }
 
             public:
-            void increment() { refCount++; }
+            // Gives up the bias so that any thread may drop the last reference directly.
+            // Only the holder of the owning reference may call this, which keeps the local
+            // count above zero throughout. On any other thread than the owner it waits
+            // until the owner is not in the middle of updating the local count.
+            void unbias() noexcept {
+                std::uintptr_t owner = ownerThread.load(std::memory_order_relaxed);
+
+                if (owner == no_owner)
+                    return;
+
+                if (owner != biased_thread::current_address()) {
+                    hand_off(owner);
+                    return;
+                }
+
+                ownerThread.store(no_owner, std::memory_order_relaxed);
+                fold(owner, static_cast<std::int64_t>(localCount.load(std::memory_order_relaxed)));
+            }
+
+            void increment() { increment(1); }
+
+            void increment(std::size_t count) {
+                bool local = update_local([&] {
+                    localCount.store(localCount.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+                });
+
+                if (not local and count != 0)
+                    sharedCount.fetch_add(static_cast<std::int64_t>(count) * shared_one, std::memory_order_relaxed);
+            }
             
             // Does not call expire(), as that is the role of the owning omni_ptr
             void decrement() noexcept {
-                refCount--;
+                std::size_t remaining = 1;
 
-                if (refCount == 0)
-                    delete this;
+                bool local = update_local([&] {
+                    remaining = localCount.load(std::memory_order_relaxed) - 1;
+                    localCount.store(remaining, std::memory_order_relaxed);
+                });
+
+                if (not local)
+                    shared_decrement();
+                else if (remaining == 0)
+                    merge_local();
             }
 
+            // Expiry always gives up the bias, since the owner's reference may be dropped
+            // on any thread and nothing else would fold the local count afterwards
             void release() noexcept {
+                assert_unborrowed();
                 originalPointer = reinterpret_cast<uintptr_t>(nullptr);
-                isExpired = true;
+                publish_expiry();
+                unbias();
                 decrement();
             }
 
             void expire() noexcept {
+                assert_unborrowed();
                 call_deleter();
-                isExpired = true;
+                publish_expiry();
+                unbias();
+            }
+
+            // Publishes expiry without destroying the stored T.
+            // Whoever calls this takes over the owner's call_deleter() and decrement().
+            void mark_expired() noexcept {
+                assert_unborrowed();
+                publish_expiry();
+                unbias();
             }
 
             bool is_expired() noexcept {
-                return isExpired;
+                return expiry.load(std::memory_order_acquire) & expired_flag;
+            }
+
+            bool is_pending() noexcept {
+                return expiry.load(std::memory_order_acquire) & pending_flag;
+            }
+
+            void materialize_if_pending() {
+                if (expiry.load(std::memory_order_acquire) & pending_flag) [[unlikely]]
+                    materialize_slow();
             }
 
+            // Expiry check of a view that constructs a pending object on the way
+            bool access() {
+                std::uint8_t state = expiry.load(std::memory_order_acquire);
+
+                if (state & expired_flag)
+                    return false;
+
+                if (state & pending_flag) [[unlikely]]
+                    materialize_slow();
+
+                return true;
+            }
+
+            #ifndef NDEBUG
+            void add_borrow() noexcept { borrowCount.fetch_add(1, std::memory_order_relaxed); }
+            void remove_borrow() noexcept { borrowCount.fetch_sub(1, std::memory_order_release); }
+            #endif
+
+            // Caller must hold a reference so the block outlives the wait
+            void wait_expired() noexcept {
+                std::uint8_t state = expiry.load(std::memory_order_acquire);
+
+                while (not (state & expired_flag)) {
+                    if (not (state & waiting_flag)) {
+                        if (not expiry.compare_exchange_weak(state, state | waiting_flag, std::memory_order_acq_rel, std::memory_order_acquire))
+                            continue;
+
+                        state |= waiting_flag;
+                    }
+
+                    expiry.wait(state, std::memory_order_acquire);
+                    state = expiry.load(std::memory_order_acquire);
+                }
+            }
+
+            // std::atomic has no timed wait, so this polls with a growing backoff instead
+            template<typename Clock, typename Duration>
+            bool wait_expired_until(const std::chrono::time_point<Clock, Duration>& deadline) noexcept {
+                constexpr auto spin_limit = std::chrono::microseconds(64);
+                constexpr auto max_backoff = std::chrono::milliseconds(1);
+
+                std::chrono::microseconds backoff(1);
+
+                while (not is_expired()) {
+                    auto now = Clock::now();
+
+                    if (now >= deadline)
+                        return false;
+
+                    if (backoff < spin_limit)
+                        std::this_thread::yield();
+                    else
+                        std::this_thread::sleep_for(std::min<std::chrono::nanoseconds>(backoff, deadline - now));
+
+                    backoff = std::min<std::chrono::microseconds>(backoff * 2, max_backoff);
+                }
+
+                return true;
+            }
+
+            // Only exact when no other thread is concurrently changing the counts
             std::size_t use_count() noexcept {
-                return refCount;
+                std::int64_t shared = sharedCount.load(std::memory_order_relaxed);
+                std::int64_t local = static_cast<std::int64_t>(localCount.load(std::memory_order_relaxed));
+
+                // The local count stays as it was once folded in
+                std::int64_t count = (shared & merged_flag) ? (shared >> 1) : local + (shared >> 1);
+
+                return static_cast<std::size_t>(std::max<std::int64_t>(count, 0));
             }
 
+            // Element count of a stored array, or 0 if the block does not know it
+            virtual std::size_t array_extent() const noexcept { return 0; }
+
+            // Tells an array known to be empty apart from one of unknown size
+            virtual bool knows_extent() const noexcept { return false; }
+
             virtual void call_deleter() noexcept = 0;
             virtual void delete_allocation() noexcept = 0;
 
@@ -180,6 +752,94 @@ namespace DxPtr {
             }
         };
 
+        // Per-thread worklist for owners of iterative_teardown types
+        class teardown_worklist {
+            std::vector<omni_block_base*> pending;
+
+            // Non-zero while a teardown runs on this thread, or while omni_teardown defers them
+            std::size_t depth = 0;
+            std::size_t deferrals = 0;
+
+            teardown_worklist() = default;
+
+            // Anything still pending when the thread exits is destroyed here,
+            // including the owners those teardowns queue in turn
+            ~teardown_worklist() {
+                while (not pending.empty())
+                    run(pending.size());
+            }
+
+            static teardown_worklist& current() noexcept {
+                thread_local teardown_worklist list;
+                return list;
+            }
+
+            static void destroy(omni_block_base* control) noexcept {
+                control->expire();
+                control->decrement();
+            }
+
+            // Destroys up to count pending owners, along with anything they queue in turn
+            std::size_t run(std::size_t count) noexcept {
+                std::size_t destroyed = 0;
+
+                depth++;
+
+                for (; destroyed < count and not pending.empty(); destroyed++) {
+                    omni_block_base* control = pending.back();
+                    pending.pop_back();
+                    destroy(control);
+                }
+
+                depth--;
+
+                return destroyed;
+            }
+
+            public:
+            // Takes over the reference of an owner being reset
+            static void retire(omni_block_base* control) noexcept {
+                teardown_worklist& list = current();
+
+                if (list.depth == 0 and list.deferrals == 0) {
+                    std::size_t outer = list.pending.size();
+
+                    list.depth++;
+                    destroy(control);
+
+                    // Only finish what this teardown queued, earlier deferred work is left to omni_teardown::step
+                    while (list.pending.size() > outer) {
+                        omni_block_base* nested = list.pending.back();
+                        list.pending.pop_back();
+                        destroy(nested);
+                    }
+
+                    list.depth--;
+                    return;
+                }
+
+                // Views see the expiry right away even though destruction waits
+                control->mark_expired();
+
+                try {
+                    list.pending.push_back(control);
+                } catch (...) {
+                    destroy(control);
+                }
+            }
+
+            static std::size_t step(std::size_t budget) noexcept {
+                return current().run(budget);
+            }
+
+            static std::size_t pending_count() noexcept {
+                return current().pending.size();
+            }
+
+            static void defer() noexcept { current().deferrals++; }
+            static void undefer() noexcept { current().deferrals--; }
+        };
+
         template<bool E>
         struct array_base { };
 
@@ -193,10 +853,12 @@ namespace DxPtr {
             , bool IsConjoined = false
             , typename Deleter = std::default_delete<T>
             , typename AP = AlignmentPolicy::Default
+            , typename Allocator = aligned_allocator
         >
         requires AlignmentPolicy::interface<T, AP>
         class omni_block final 
         : Deleter
+        , Allocator
         , array_base<std::is_unbounded_array_v<T> and IsConjoined>
         , public omni_block_base {
             static constexpr bool IsDefaultDeleter = std::is_same_v<Deleter, std::default_delete<T>>;
@@ -254,9 +916,26 @@ namespace DxPtr {
             omni_block(pointer ptr, Deleter deleter)
             requires (not IsDefaultDeleter)
             : Deleter(std::move(deleter)), omni_block_base(reinterpret_cast<uintptr_t>(ptr)) { }
+
+            omni_block(pointer ptr, Allocator allocator)
+            requires (IsDefaultDeleter and IsConjoined)
+            : Allocator(std::move(allocator)), omni_block_base(reinterpret_cast<uintptr_t>(ptr)) { }
           
             pointer get() const noexcept { return reinterpret_cast<pointer>(originalPointer); }
 
+            std::size_t array_extent() const noexcept override {
+                if constexpr (std::is_unbounded_array_v<T> and IsConjoined)
+                    return array_base<true>::array_size;
+                else if constexpr (std::is_bounded_array_v<T>)
+                    return std::extent_v<T>;
+                else
+                    return 0;
+            }
+
+            bool knows_extent() const noexcept override {
+                return (std::is_unbounded_array_v<T> and IsConjoined) or std::is_bounded_array_v<T>;
+            }
+
             void call_deleter() noexcept override {
                 // If conjoined, stored T is a part of this allocation
                 // and we cannot call a regular delete on it.
@@ -265,13 +944,10 @@ namespace DxPtr {
                     if constexpr (not IsStoringArray) {
                         get()->~T();
                     } else {
-                        for (std::size_t i = 0; i < array_base<true>::array_size; i++) {
-                            if constexpr (IsDefaultDeleter) {
-                                get()[i].~element_type();
-                            } else {
-                                std::cerr << "Not implemented deleter for arrays";
-                            }
-                        }
+                        static_assert(IsDefaultDeleter, "Conjoined arrays are destroyed in place, so they cannot take a custom deleter");
+
+                        for (std::size_t i = 0; i < array_base<true>::array_size; i++)
+                            get()[i].~element_type();
                     }
                 } else {
                     Deleter::operator()(reinterpret_cast<pointer>(originalPointer));
@@ -296,6 +972,14 @@ namespace DxPtr {
                     , static_cast<std::size_t>(alignT)
                 );
 
+                // Give the control block and the stored object separate cache lines,
+                // and pad the stored region so nothing else shares its last line
+                if constexpr (AlignmentPolicy::is_cache_isolated<T, AP>()) {
+                    alignTarget = std::max(alignTarget, static_cast<std::align_val_t>(cache_line_size));
+                    controlRegionSize = round_up_to_nearest_multiple(controlRegionSize, cache_line_size);
+                    storedRegionSize = round_up_to_nearest_multiple(storedRegionSize, cache_line_size);
+                }
+
                 std::ptrdiff_t offsetControl = 0;
                 std::ptrdiff_t offsetStored = controlRegionSize;
 
@@ -311,14 +995,29 @@ namespace DxPtr {
             template<typename... Args>
             requires (IsConjoined and not IsStoringArray)
             static omni_block* make_conjoined(Args&&... args) {
+                return make_conjoined_with(Allocator{}, std::forward<Args>(args)...);
+            }
+
+            // The block keeps the allocator to hand the buffer back in delete_allocation()
+            template<typename... Args>
+            requires (IsConjoined and not IsStoringArray)
+            static omni_block* make_conjoined_with(Allocator allocator, Args&&... args) {
                 constexpr allocation info = get_conjoined_buffer_info(AlignmentPolicy::get_stored_size<T, AP>());
                 
                 // std::byte* buffer = new (info.alignment) std::byte[info.get_total_size()];
-                std::byte* buffer = static_cast<std::byte*>(detail::aligned_alloc(info.alignment, info.get_total_size()));
+                std::byte* buffer = static_cast<std::byte*>(allocator.allocate(info.alignment, info.get_total_size()));
 
                 // Create our objects in the proper locations
-                T* stored = new(buffer + info.offsetStored) T(std::forward<Args>(args)...);
-                omni_block* control = new(buffer + info.offsetControl) omni_block(stored);
+                T* stored;
+
+                try {
+                    stored = new(buffer + info.offsetStored) T(std::forward<Args>(args)...);
+                } catch (...) {
+                    allocator.deallocate(buffer, info.alignment, info.get_total_size());
+                    throw;
+                }
+
+                omni_block* control = new(buffer + info.offsetControl) omni_block(stored, std::move(allocator));
 
                 // std::cout << "Created conjoined omni_block at " << control << "\n";
                 // std::cout << "Buffer location: " << (void*) buffer << "\n";
@@ -329,18 +1028,24 @@ namespace DxPtr {
 
             static omni_block* make_conjoined(std::size_t size)
             requires (IsConjoined and std::is_array_v<T>) {             
+                // Elements are built as a plain array, so the policy may only align the array as a whole
+                static_assert(AlignmentPolicy::get_element_stride<element_type, AP>() == sizeof(element_type),
+                    "Arrays are only supported by alignment policies that keep the natural element stride");
+
                 allocation info = get_conjoined_buffer_info(AlignmentPolicy::get_stored_size<T, AP>(size));
                 
                 // std::byte* buffer = new (info.alignment) std::byte[info.get_total_size()];
-                std::byte* buffer = static_cast<std::byte*>(detail::aligned_alloc(info.alignment, info.get_total_size()));
+                std::byte* buffer = static_cast<std::byte*>(Allocator{}.allocate(info.alignment, info.get_total_size()));
                
                 // Create our objects in the proper locations
                 pointer stored;
-                
-                if constexpr (std::is_same_v<AP, AlignmentPolicy::Default>)
+
+                try {
                     stored = new(buffer + info.offsetStored) element_type[size]{};
-                else
-                    throw std::runtime_error("Unimplemented");
+                } catch (...) {
+                    Allocator{}.deallocate(buffer, info.alignment, info.get_total_size());
+                    throw;
+                }
 
                 omni_block* control = new(buffer + info.offsetControl) omni_block(stored);
 
@@ -358,35 +1063,110 @@ namespace DxPtr {
             void delete_allocation() noexcept override {
                 omni_block* alloc = this;
 
-                alloc->~omni_block();
-                
                 if constexpr (not IsConjoined) {
+                    alloc->~omni_block();
+
                     // std::cout << "Deleting non-conjoined omni_block at " << alloc << "\n";
                     ::operator delete(alloc, sizeof(omni_block));
                 } else {
-                    // allocation info = [&]() {
-                    //     if constexpr (std::is_array_v<T>) {
-                    //         return get_conjoined_buffer_info(
-                    //             AlignmentPolicy::get_stored_size<T, AP>(array_base<true>::array_size)
-                    //         );
-                    //     } else {
-                    //         return get_conjoined_buffer_info(
-                    //             AlignmentPolicy::get_stored_size<T, AP>()
-                    //         );
-                    //     }
-                    // }();
-                    
-                    // std::byte* bufferBegin = reinterpret_cast<std::byte*>(alloc);
-                    detail::aligned_free(alloc);
-                    // std::cout << "Deleting conjoined omni_block at " << alloc << "\n";
-                    // std::cout << "Buffer location: " << (void*) bufferBegin << "\n";
-                    // std::cout << info << "\n";
-
-                    // ::operator delete(bufferBegin, info.get_total_size(), info.alignment);
+                    allocation info = [&]() {
+                        if constexpr (std::is_array_v<T>) {
+                            return get_conjoined_buffer_info(
+                                AlignmentPolicy::get_stored_size<T, AP>(array_base<true>::array_size)
+                            );
+                        } else {
+                            return get_conjoined_buffer_info(
+                                AlignmentPolicy::get_stored_size<T, AP>()
+                            );
+                        }
+                    }();
+
+                    Allocator allocator = std::move(static_cast<Allocator&>(*alloc));
+
+                    alloc->~omni_block();
+
+                    // The control block sits at the start of the buffer
+                    allocator.deallocate(alloc, info.alignment, info.get_total_size());
                 }
             }
         };
 
+    }
+
+    // Non-counting access to an object checked alive once, for tight loops and parameters.
+    // Taking one never touches the reference counts, and in release builds it is a plain
+    // pointer. Debug builds count live borrows on the control block and assert if the
+    // owner expires the object while any remain.
+    template<typename T>
+    class omni_borrow {
+        T* data = nullptr;
+
+        #ifndef NDEBUG
+        detail::omni_block_base* control = nullptr;
+
+        void acquire() noexcept {
+            if (control != nullptr)
+                control->add_borrow();
+        }
+
+        void drop() noexcept {
+            if (control != nullptr)
+                control->remove_borrow();
+        }
+        #endif
+
+        public:
+        using element_type = T;
+
+        constexpr omni_borrow() noexcept = default;
+
+        #ifndef NDEBUG
+        omni_borrow(T* data, detail::omni_block_base* control) noexcept : data(data), control(data ? control : nullptr) {
+            acquire();
+        }
+
+        omni_borrow(const omni_borrow& copy) noexcept : data(copy.data), control(copy.control) {
+            acquire();
+        }
+
+        template<typename U>
+        requires std::is_convertible_v<U*, T*>
+        omni_borrow(const omni_borrow<U>& copy) noexcept : data(copy.data), control(copy.control) {
+            acquire();
+        }
+
+        omni_borrow& operator=(const omni_borrow& copy) noexcept {
+            omni_borrow(copy).swap(*this);
+            return *this;
+        }
+
+        ~omni_borrow() {
+            drop();
+        }
+
+        void swap(omni_borrow& other) noexcept {
+            std::swap(data, other.data);
+            std::swap(control, other.control);
+        }
+        #else
+        omni_borrow(T* data, detail::omni_block_base*) noexcept : data(data) { }
+
+        template<typename U>
+        requires std::is_convertible_v<U*, T*>
+        omni_borrow(const omni_borrow<U>& copy) noexcept : data(copy.data) { }
+        #endif
+
+        T* get() const noexcept { return data; }
+        T& operator*() const noexcept { return *data; }
+        T* operator->() const noexcept { return data; }
+
+        explicit operator bool() const noexcept { return data != nullptr; }
+
+        template<typename U>
+        friend class omni_borrow;
+    };
+
+    namespace detail {
         template<bool F, typename T>
         struct weak_type_alias_provider;
 
@@ -408,6 +1188,8 @@ namespace DxPtr {
             constexpr static bool is_owning = IsOwning;
 
             private:
+            constexpr static bool is_lazy = lazy_construction<std::remove_cv_t<element_type>>;
+
             using control_base_t = omni_block_base;
 
             template<bool IsConjoined = false, typename Deleter = std::default_delete<T>>
@@ -582,15 +1364,27 @@ namespace DxPtr {
             }
             #endif
 
-            pointer get() const noexcept {
-                if constexpr (IsOwning)
+            pointer get() const noexcept(not is_lazy) {
+                if constexpr (IsOwning and is_lazy) {
+                    if (control != nullptr)
+                        control->materialize_if_pending();
+
                     return data;
+                } else if constexpr (IsOwning)
+                    return data;
+                else if constexpr (is_lazy)
+                    return control != nullptr and control->access() ? data : nullptr;
                 else if (not expired())
                     return data;
                 else
                     return nullptr;
             }
 
+            // Checks expiry once. The result is empty if the object is already gone.
+            omni_borrow<element_type> borrow() const noexcept(not is_lazy) {
+                return omni_borrow<element_type>(get(), control);
+            }
+
             void reset() noexcept {
                 #ifdef _DEBUG
                 // std::cout << "reset omni_ptr " << (IsOwning ? "(owning)" : "(not owning)")
@@ -600,6 +1394,12 @@ namespace DxPtr {
                 if (control == nullptr)
                     return;
 
+                if constexpr (IsOwning and iterative_teardown<std::remove_cv_t<element_type>>) {
+                    teardown_worklist::retire(std::exchange(control, nullptr));
+                    data = nullptr;
+                    return;
+                }
+
                 if constexpr (IsOwning)
                     control->expire();
                 
@@ -609,6 +1409,19 @@ namespace DxPtr {
                 control = nullptr;
             }
 
+            // Expires immediately, but hands destruction of the stored T
+            // and the owner's reference to the reclaimer
+            template<typename Reclaimer>
+            requires IsOwning and requires(Reclaimer& r, control_base_t* c) { r.retire(c); }
+            void reset(Reclaimer& reclaimer) noexcept {
+                if (control == nullptr)
+                    return;
+
+                control->mark_expired();
+                reclaimer.retire(std::exchange(control, nullptr));
+                data = nullptr;
+            }
+
             void reset(pointer other)
             requires IsOwning {
                 omni_ptr(other).swap(*this);
@@ -630,6 +1443,20 @@ namespace DxPtr {
                 return control == nullptr || control->is_expired();
             }
 
+            // Blocks until the owner expires the object
+            void wait_expired() const noexcept
+            requires (not IsOwning) {
+                if (control != nullptr)
+                    control->wait_expired();
+            }
+
+            // Returns whether the object expired before the timeout
+            template<typename Rep, typename Period>
+            bool wait_expired_for(const std::chrono::duration<Rep, Period>& timeout) const noexcept
+            requires (not IsOwning) {
+                return control == nullptr or control->wait_expired_until(std::chrono::steady_clock::now() + timeout);
+            }
+
             long use_count() const noexcept {
                 if (control == nullptr)
                     return 0;
@@ -643,22 +1470,52 @@ namespace DxPtr {
                 std::swap(control, other.control);
             }
 
+            // Owner identity is the control block, which stays put while any view of it lives.
+            // Unlike operator==, expired views of different owners stay distinct.
+            template<typename U, bool O2, typename AP2>
+            bool owner_before(const omni_ptr<U, O2, AP2>& other) const noexcept {
+                return std::less<const omni_block_base*>{}(control, other.control);
+            }
+
+            template<typename U, bool O2, typename AP2>
+            bool owner_equal(const omni_ptr<U, O2, AP2>& other) const noexcept {
+                return control == other.control;
+            }
+
+            std::size_t owner_hash() const noexcept {
+                return std::hash<const omni_block_base*>{}(control);
+            }
+
             // Pointer operator overloads
-            T& operator*() const noexcept {
+            T& operator*() const noexcept(not is_lazy) {
+                if constexpr (is_lazy)
+                    if (control != nullptr)
+                        control->materialize_if_pending();
+
                 return *data;
             }
 
-            pointer operator->() const noexcept {
+            pointer operator->() const noexcept(not is_lazy) {
+                if constexpr (is_lazy)
+                    if (control != nullptr)
+                        control->materialize_if_pending();
+
                 return data;
             }
 
             element_type& operator[](std::ptrdiff_t index) const 
             requires std::is_array_v<T> {
-                static_assert(std::is_same_v<AP, AlignmentPolicy::Default>, "Custom alignment arrays unimplemented");
+                static_assert(AlignmentPolicy::get_element_stride<element_type, AP>() == sizeof(element_type), "Custom alignment arrays unimplemented");
 
                 return data[index];
             }
 
+            // Only known for arrays made by make_omni, 0 for adopted raw arrays
+            std::size_t size() const noexcept
+            requires std::is_unbounded_array_v<T> {
+                return control == nullptr ? 0 : control->array_extent();
+            }
+
             operator bool() const noexcept {
                 if constexpr (IsOwning)
                     return data != nullptr;
@@ -686,6 +1543,9 @@ namespace DxPtr {
 
             template<typename T2, bool O2, typename AP2>
             friend control_base_t* get_control_block(const detail::omni_ptr<T2, O2, AP2>&);
+
+            template<typename T2, bool O2, typename AP2>
+            friend typename detail::omni_ptr<T2, O2, AP2>::pointer get_data_raw(const detail::omni_ptr<T2, O2, AP2>&);
         };
 
         template<typename U, bool O1, typename A, typename V, bool O2, typename B>
@@ -739,8 +1599,41 @@ namespace DxPtr {
         omni_block_base* get_control_block(const detail::omni_ptr<T, O, AP>& omni) {
             return omni.control;
         }
+
+        // Unlike get(), does not null the result when expired
+        template<typename T, bool O, typename AP>
+        typename detail::omni_ptr<T, O, AP>::pointer get_data_raw(const detail::omni_ptr<T, O, AP>& omni) {
+            return omni.data;
+        }
     }
 
+    // Spreads teardown of iterative_teardown types over time.
+    // While an omni_teardown is alive, resetting such an owner on this thread only marks
+    // it expired and queues it, and step() then destroys a bounded number of queued owners,
+    // for instance once per frame. Owners nested inside them are queued as they are reached.
+    class omni_teardown {
+        public:
+        omni_teardown() noexcept { detail::teardown_worklist::defer(); }
+        ~omni_teardown() { detail::teardown_worklist::undefer(); }
+
+        omni_teardown(const omni_teardown&) = delete;
+        omni_teardown& operator=(const omni_teardown&) = delete;
+
+        // Destroys at most budget queued owners, returns how many were destroyed
+        static std::size_t step(std::size_t budget) noexcept {
+            return detail::teardown_worklist::step(budget);
+        }
+
+        static void drain() noexcept {
+            while (step(std::numeric_limits<std::size_t>::max()) != 0) { }
+        }
+
+        // Owners queued on this thread and not yet destroyed
+        static std::size_t pending() noexcept {
+            return detail::teardown_worklist::pending_count();
+        }
+    };
+
     template<typename T, typename AP = AlignmentPolicy::Default>
     class omni_ptr : public detail::omni_ptr<T, true, AP> {
         using detail::omni_ptr<T, true, AP>::omni_ptr;
@@ -764,6 +1657,35 @@ namespace DxPtr {
 
     template<typename T, typename AP = AlignmentPolicy::Default>
     omni_ref(omni_ptr<T, AP>) -> omni_ref<T, AP>;
+
+    // Owner identity function objects, for keying containers by omni pointers that may expire.
+    // Like std::owner_less, owners, views and refs of the same object all compare equal.
+    struct omni_owner_less {
+        using is_transparent = void;
+
+        template<typename U, bool O1, typename A, typename V, bool O2, typename B>
+        bool operator()(const detail::omni_ptr<U, O1, A>& lhs, const detail::omni_ptr<V, O2, B>& rhs) const noexcept {
+            return lhs.owner_before(rhs);
+        }
+    };
+
+    struct omni_owner_equal {
+        using is_transparent = void;
+
+        template<typename U, bool O1, typename A, typename V, bool O2, typename B>
+        bool operator()(const detail::omni_ptr<U, O1, A>& lhs, const detail::omni_ptr<V, O2, B>& rhs) const noexcept {
+            return lhs.owner_equal(rhs);
+        }
+    };
+
+    struct omni_owner_hash {
+        using is_transparent = void;
+
+        template<typename U, bool O, typename A>
+        std::size_t operator()(const detail::omni_ptr<U, O, A>& omni) const noexcept {
+            return omni.owner_hash();
+        }
+    };
     
     namespace detail {
         template<template<typename, typename> typename Ptr, typename T, typename AP>
@@ -0,0 +1,328 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+// std::atomic specializations for omni_view and omni_ref.
+// The (data, control) pair is swapped as one 16 byte word using a double-width CAS,
+// and loads use split reference counting: a reader first bumps an external count
+// packed into the stored word, then takes a real reference on the control block,
+// then hands the external count back. Writers that swap a value out transfer its
+// outstanding external count into the control block's refCount.
+
+#if (defined(__x86_64__) && defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)) || (defined(_MSC_VER) && defined(_M_X64))
+    #define DXPTR_ATOMIC_OMNI_LOCK_FREE 1
+#else
+    #define DXPTR_ATOMIC_OMNI_LOCK_FREE 0
+#endif
+
+namespace DxPtr {
+    namespace detail {
+        static_assert(sizeof(void*) == 8, "atomic omni pointers require 64-bit pointers");
+
+        // [data | generation] [control | external count]
+        // User space addresses fit in the low 48 bits, so the top 16 bits of each word are free.
+        // The generation guards the external count against ABA when the same value is stored again.
+        struct alignas(16) atomic_omni_word {
+            static constexpr int tag_shift = 48;
+            static constexpr std::uint64_t pointer_mask = (std::uint64_t(1) << tag_shift) - 1;
+
+            std::uint64_t data = 0;
+            std::uint64_t control = 0;
+
+            static atomic_omni_word make(const void* data, omni_block_base* control, std::uint16_t generation) noexcept {
+                return atomic_omni_word{
+                      .data = reinterpret_cast<std::uint64_t>(data) | (std::uint64_t(generation) << tag_shift)
+                    , .control = reinterpret_cast<std::uint64_t>(control)
+                };
+            }
+
+            std::uint64_t get_data() const noexcept { return data & pointer_mask; }
+            std::uint16_t get_generation() const noexcept { return static_cast<std::uint16_t>(data >> tag_shift); }
+
+            omni_block_base* get_control() const noexcept {
+                return reinterpret_cast<omni_block_base*>(control & pointer_mask);
+            }
+
+            std::uint16_t get_external_count() const noexcept {
+                return static_cast<std::uint16_t>(control >> tag_shift);
+            }
+
+            atomic_omni_word with_external_count(std::uint16_t count) const noexcept {
+                return atomic_omni_word{
+                      .data = data
+                    , .control = (control & pointer_mask) | (std::uint64_t(count) << tag_shift)
+                };
+            }
+
+            // Same stored value and generation, ignoring the external count
+            bool same_slot(const atomic_omni_word& other) const noexcept {
+                return data == other.data and get_control() == other.get_control();
+            }
+        };
+
+        class atomic_omni_cell {
+            #if DXPTR_ATOMIC_OMNI_LOCK_FREE and not defined(_MSC_VER)
+            __extension__ using word_t = unsigned __int128;
+
+            mutable word_t word = 0;
+
+            public:
+            constexpr atomic_omni_cell() noexcept = default;
+            atomic_omni_cell(atomic_omni_word initial) noexcept : word(std::bit_cast<word_t>(initial)) { }
+
+            // On failure, expected is updated with the current value
+            bool compare_exchange(atomic_omni_word& expected, atomic_omni_word desired) noexcept {
+                word_t expectedWord = std::bit_cast<word_t>(expected);
+                word_t previous = __sync_val_compare_and_swap(&word, expectedWord, std::bit_cast<word_t>(desired));
+
+                if (previous == expectedWord)
+                    return true;
+
+                expected = std::bit_cast<atomic_omni_word>(previous);
+                return false;
+            }
+
+            atomic_omni_word load() const noexcept {
+                return std::bit_cast<atomic_omni_word>(__sync_val_compare_and_swap(&word, word_t(0), word_t(0)));
+            }
+
+            #elif DXPTR_ATOMIC_OMNI_LOCK_FREE
+            mutable atomic_omni_word word;
+
+            public:
+            constexpr atomic_omni_cell() noexcept = default;
+            atomic_omni_cell(atomic_omni_word initial) noexcept : word(initial) { }
+
+            bool compare_exchange(atomic_omni_word& expected, atomic_omni_word desired) noexcept {
+                return _InterlockedCompareExchange128(
+                      reinterpret_cast<volatile long long*>(&word)
+                    , static_cast<long long>(desired.control)
+                    , static_cast<long long>(desired.data)
+                    , reinterpret_cast<long long*>(&expected)
+                ) == 1;
+            }
+
+            atomic_omni_word load() const noexcept {
+                atomic_omni_word current{};
+                _InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(&word), 0, 0, reinterpret_cast<long long*>(&current));
+                return current;
+            }
+
+            #else
+            // No double-width CAS on this platform, guard the word with a spinlock instead
+            atomic_omni_word word;
+            mutable std::atomic_flag lock;
+
+            void acquire() const noexcept {
+                while (lock.test_and_set(std::memory_order_acquire))
+                    lock.wait(true, std::memory_order_relaxed);
+            }
+
+            void release() const noexcept {
+                lock.clear(std::memory_order_release);
+                lock.notify_one();
+            }
+
+            public:
+            constexpr atomic_omni_cell() noexcept = default;
+            atomic_omni_cell(atomic_omni_word initial) noexcept : word(initial) { }
+
+            bool compare_exchange(atomic_omni_word& expected, atomic_omni_word desired) noexcept {
+                acquire();
+
+                bool equal = word.data == expected.data and word.control == expected.control;
+
+                if (equal)
+                    word = desired;
+                else
+                    expected = word;
+
+                release();
+                return equal;
+            }
+
+            atomic_omni_word load() const noexcept {
+                acquire();
+                atomic_omni_word current = word;
+                release();
+                return current;
+            }
+            #endif
+        };
+
+        // Shared implementation of std::atomic<omni_view<T>> and std::atomic<omni_ref<T>>.
+        // Memory order arguments are accepted for interface compatibility, all operations are seq_cst.
+        template<typename Ptr>
+        class atomic_omni {
+            using pointer = typename Ptr::pointer;
+
+            mutable atomic_omni_cell cell;
+
+            static atomic_omni_word to_word(const Ptr& ptr, std::uint16_t generation) noexcept {
+                return atomic_omni_word::make(get_data_raw(ptr), get_control_block(ptr), generation);
+            }
+
+            static Ptr adopt(const atomic_omni_word& word) noexcept {
+                if (word.get_control() == nullptr)
+                    return Ptr{};
+
+                return make_omni_ptr_raw<Ptr>(reinterpret_cast<pointer>(word.get_data()), word.get_control());
+            }
+
+            static bool holds(const atomic_omni_word& word, const Ptr& ptr) noexcept {
+                return word.get_data() == reinterpret_cast<std::uint64_t>(get_data_raw(ptr))
+                   and word.get_control() == get_control_block(ptr);
+            }
+
+            public:
+            using value_type = Ptr;
+
+            static constexpr bool is_always_lock_free = DXPTR_ATOMIC_OMNI_LOCK_FREE;
+
+            constexpr atomic_omni() noexcept = default;
+            constexpr atomic_omni(std::nullptr_t) noexcept { }
+
+            atomic_omni(Ptr desired) noexcept : cell(to_word(desired, 0)) {
+                set_omni_ptr_null_raw(desired);
+            }
+
+            atomic_omni(const atomic_omni&) = delete;
+            atomic_omni& operator=(const atomic_omni&) = delete;
+
+            // No loads may be in flight during destruction, so the external count is zero
+            ~atomic_omni() {
+                if (auto* control = cell.load().get_control())
+                    control->decrement();
+            }
+
+            bool is_lock_free() const noexcept {
+                return is_always_lock_free;
+            }
+
+            Ptr load([[maybe_unused]] std::memory_order order = std::memory_order_seq_cst) const noexcept {
+                atomic_omni_word current = cell.load();
+                atomic_omni_word pinned;
+
+                // Pin the current value with an external reference
+                do {
+                    if (current.get_control() == nullptr)
+                        return Ptr{};
+
+                    pinned = current.with_external_count(current.get_external_count() + 1);
+                } while (not cell.compare_exchange(current, pinned));
+
+                omni_block_base* control = pinned.get_control();
+                control->increment();
+
+                // Hand the external reference back. If the value was swapped out in the meantime,
+                // the writer moved our external reference into refCount, so drop it from there instead.
+                atomic_omni_word expected = pinned;
+
+                while (true) {
+                    if (not expected.same_slot(pinned)) {
+                        control->decrement();
+                        break;
+                    }
+
+                    if (cell.compare_exchange(expected, expected.with_external_count(expected.get_external_count() - 1)))
+                        break;
+                }
+
+                return make_omni_ptr_raw<Ptr>(reinterpret_cast<pointer>(pinned.get_data()), control);
+            }
+
+            void store(Ptr desired, [[maybe_unused]] std::memory_order order = std::memory_order_seq_cst) noexcept {
+                exchange(std::move(desired));
+            }
+
+            Ptr exchange(Ptr desired, [[maybe_unused]] std::memory_order order = std::memory_order_seq_cst) noexcept {
+                atomic_omni_word current = cell.load();
+
+                while (not cell.compare_exchange(current, to_word(desired, current.get_generation() + 1))) { }
+
+                // The stored word now owns desired's reference
+                set_omni_ptr_null_raw(desired);
+
+                if (auto* control = current.get_control())
+                    control->increment(current.get_external_count());
+
+                return adopt(current);
+            }
+
+            bool compare_exchange_strong(
+                  Ptr& expected
+                , Ptr desired
+                , [[maybe_unused]] std::memory_order success = std::memory_order_seq_cst
+                , [[maybe_unused]] std::memory_order failure = std::memory_order_seq_cst
+            ) noexcept {
+                atomic_omni_word current = cell.load();
+
+                while (true) {
+                    if (not holds(current, expected)) {
+                        Ptr actual = load();
+
+                        // Value went back to expected between the two reads, try again
+                        if (holds(to_word(actual, 0), expected)) {
+                            current = cell.load();
+                            continue;
+                        }
+
+                        expected = std::move(actual);
+                        return false;
+                    }
+
+                    if (cell.compare_exchange(current, to_word(desired, current.get_generation() + 1)))
+                        break;
+                }
+
+                set_omni_ptr_null_raw(desired);
+
+                // Drop the reference the old word held, after accounting for in-flight loads
+                if (auto* control = current.get_control()) {
+                    control->increment(current.get_external_count());
+                    control->decrement();
+                }
+
+                return true;
+            }
+
+            bool compare_exchange_weak(
+                  Ptr& expected
+                , Ptr desired
+                , std::memory_order success = std::memory_order_seq_cst
+                , std::memory_order failure = std::memory_order_seq_cst
+            ) noexcept {
+                return compare_exchange_strong(expected, std::move(desired), success, failure);
+            }
+
+            operator Ptr() const noexcept {
+                return load();
+            }
+
+            void operator=(Ptr desired) noexcept {
+                store(std::move(desired));
+            }
+        };
+    }
+}
+
+namespace std {
+    template<typename T, typename AP>
+    struct atomic<DxPtr::omni_view<T, AP>> : DxPtr::detail::atomic_omni<DxPtr::omni_view<T, AP>> {
+        using DxPtr::detail::atomic_omni<DxPtr::omni_view<T, AP>>::atomic_omni;
+        using DxPtr::detail::atomic_omni<DxPtr::omni_view<T, AP>>::operator=;
+    };
+
+    template<typename T, typename AP>
+    struct atomic<DxPtr::omni_ref<T, AP>> : DxPtr::detail::atomic_omni<DxPtr::omni_ref<T, AP>> {
+        using DxPtr::detail::atomic_omni<DxPtr::omni_ref<T, AP>>::atomic_omni;
+        using DxPtr::detail::atomic_omni<DxPtr::omni_ref<T, AP>>::operator=;
+    };
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <new>
+
+// Memory budgets cap the bytes that omni allocations of one tag may hold at once.
+// budget.make<T>() charges the whole conjoined buffer, control block and padding
+// included, and the charge is returned when the buffer is freed. Views keep the
+// buffer alive after their owner expires, so they also keep it charged.
+//
+// When an allocation does not fit, the budget's evictor is asked to make room,
+// typically by resetting the least recently used owners it knows about. If that
+// cannot free enough, make() throws omni_budget_exceeded, and make(std::nothrow)
+// returns an empty owner instead.
+
+namespace DxPtr {
+    class omni_budget_exceeded : public std::bad_alloc {
+        public:
+        const char* what() const noexcept override {
+            return "omni memory budget exceeded";
+        }
+    };
+
+    namespace detail {
+        // Shared by a budget and every buffer charged to it, so buffers
+        // outliving their budget can still hand their bytes back
+        class omni_budget_state {
+            std::atomic<std::size_t> liveBytes = 0;
+            std::atomic<std::size_t> peakBytes = 0;
+            std::atomic<std::size_t> limitBytes;
+            std::atomic<std::size_t> references = 1;
+
+            // Serializes evictions, and guards the evictor itself
+            std::mutex evictMutex;
+            std::function<bool(std::size_t)> evictor;
+
+            bool try_charge(std::size_t size) noexcept {
+                std::size_t live = liveBytes.load(std::memory_order_relaxed);
+
+                do {
+                    std::size_t limit = limitBytes.load(std::memory_order_relaxed);
+
+                    // A lowered limit may already be below what is live
+                    if (live > limit or size > limit - live)
+                        return false;
+                } while (not liveBytes.compare_exchange_weak(live, live + size, std::memory_order_relaxed));
+
+                std::size_t peak = peakBytes.load(std::memory_order_relaxed);
+
+                while (live + size > peak and not peakBytes.compare_exchange_weak(peak, live + size, std::memory_order_relaxed)) { }
+
+                return true;
+            }
+
+            public:
+            explicit omni_budget_state(std::size_t limit) noexcept : limitBytes(limit) { }
+
+            omni_budget_state(const omni_budget_state&) = delete;
+            omni_budget_state& operator=(const omni_budget_state&) = delete;
+
+            // Evicts until size fits. Returns false if the evictor gives up first.
+            bool charge(std::size_t size) {
+                if (try_charge(size))
+                    return true;
+
+                std::scoped_lock lock(evictMutex);
+
+                while (not try_charge(size)) {
+                    if (not evictor or not evictor(size))
+                        return false;
+                }
+
+                return true;
+            }
+
+            void credit(std::size_t size) noexcept {
+                liveBytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            void acquire() noexcept {
+                references.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void release() noexcept {
+                if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+
+            void set_evictor(std::function<bool(std::size_t)> fn) {
+                std::scoped_lock lock(evictMutex);
+                evictor = std::move(fn);
+            }
+
+            void set_limit(std::size_t limit) noexcept {
+                limitBytes.store(limit, std::memory_order_relaxed);
+            }
+
+            std::size_t limit() const noexcept {
+                return limitBytes.load(std::memory_order_relaxed);
+            }
+
+            std::size_t live_bytes() const noexcept {
+                return liveBytes.load(std::memory_order_relaxed);
+            }
+
+            std::size_t peak_bytes() const noexcept {
+                return peakBytes.load(std::memory_order_relaxed);
+            }
+        };
+
+        class omni_budget_allocator {
+            omni_budget_state* state;
+
+            public:
+            explicit omni_budget_allocator(omni_budget_state* state) noexcept : state(state) { }
+
+            void* allocate(std::align_val_t alignment, std::size_t size) {
+                if (not state->charge(size))
+                    throw omni_budget_exceeded();
+
+                void* buffer = aligned_alloc(alignment, size);
+
+                if (buffer == nullptr) {
+                    state->credit(size);
+                    throw std::bad_alloc();
+                }
+
+                state->acquire();
+                return buffer;
+            }
+
+            void deallocate(void* buffer, std::align_val_t, std::size_t size) noexcept {
+                aligned_free(buffer);
+                state->credit(size);
+                state->release();
+            }
+        };
+    }
+
+    // Byte budget for the omni allocations made through it.
+    // Any thread may make and release through a budget.
+    class omni_budget {
+        detail::omni_budget_state* state;
+
+        public:
+        static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+        explicit omni_budget(std::size_t limit = unlimited) : state(new detail::omni_budget_state(limit)) { }
+
+        omni_budget(const omni_budget&) = delete;
+        omni_budget& operator=(const omni_budget&) = delete;
+
+        ~omni_budget() {
+            state->release();
+        }
+
+        // Throws omni_budget_exceeded if the buffer does not fit even after eviction
+        template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+        requires (not std::is_array_v<T> and AlignmentPolicy::interface<T, AP> and detail::correct_constructor_args<T, Args...>)
+        omni_ptr<T, AP> make(Args&&... args) {
+            using block_t = detail::omni_block<T, true, std::default_delete<T>, AP, detail::omni_budget_allocator>;
+
+            auto* block = block_t::make_conjoined_with(detail::omni_budget_allocator(state), std::forward<Args>(args)...);
+
+            return detail::make_omni_ptr_raw<omni_ptr<T, AP>>(block->get(), block);
+        }
+
+        // Empty owner if the buffer does not fit even after eviction.
+        // Like new (std::nothrow), exceptions from T's constructor still propagate.
+        template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+        requires (not std::is_array_v<T> and AlignmentPolicy::interface<T, AP> and detail::correct_constructor_args<T, Args...>)
+        omni_ptr<T, AP> make(std::nothrow_t, Args&&... args) {
+            try {
+                return make<T, AP>(std::forward<Args>(args)...);
+            } catch (const omni_budget_exceeded&) {
+                return nullptr;
+            }
+        }
+
+        // Called with the bytes needed whenever an allocation does not fit, until it fits
+        // or fn returns false. Resetting owners made through this budget frees their bytes
+        // once no views are left. fn runs under a lock, so it must not make through this budget.
+        void set_evictor(std::function<bool(std::size_t)> fn) {
+            state->set_evictor(std::move(fn));
+        }
+
+        // Lowering the limit evicts nothing, it only refuses allocations until enough is freed
+        void set_limit(std::size_t limit) noexcept {
+            state->set_limit(limit);
+        }
+
+        std::size_t limit() const noexcept {
+            return state->limit();
+        }
+
+        std::size_t live_bytes() const noexcept {
+            return state->live_bytes();
+        }
+
+        std::size_t peak_bytes() const noexcept {
+            return state->peak_bytes();
+        }
+
+        // Buffer size make<T, AP>() charges
+        template<typename T, typename AP = AlignmentPolicy::Default>
+        requires (not std::is_array_v<T> and AlignmentPolicy::interface<T, AP>)
+        static constexpr std::size_t charge_of() noexcept {
+            using block_t = detail::omni_block<T, true, std::default_delete<T>, AP, detail::omni_budget_allocator>;
+
+            return block_t::get_conjoined_buffer_info(AlignmentPolicy::get_stored_size<T, AP>()).get_total_size();
+        }
+    };
+
+    // Process-wide budget for a tag type, unlimited until given a limit.
+    // Using T itself as the tag caps the memory all budgeted Ts may hold.
+    template<typename Tag>
+    omni_budget& omni_budget_for() {
+        static omni_budget budget;
+        return budget;
+    }
+}
@@ -0,0 +1,528 @@
+#pragma once
+
+#include "OmniVector.hpp"
+#include <span>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define DXPTR_HAS_MREMAP 1
+#else
+#define DXPTR_HAS_MREMAP 0
+#endif
+
+// Growable shared buffers. An omni_ptr<T[]> has a fixed size, and replacing it with a
+// bigger one expires every view of the old one. omni_buffer<T> instead keeps its data
+// pointer, size and capacity in the control block, and its views look them up there on
+// every access, so they stay valid across push_back, resize and reserve.
+//
+// Element views hold the control block and an index rather than an address.
+//
+// Large buffers of trivially relocatable types are grown with mremap on Linux, which
+// moves the pages instead of copying them. Smaller ones use realloc where possible,
+// like omni_vector.
+//
+// As with std::vector, growing the buffer while another thread reads it is a data race.
+// Copying and releasing views is thread safe.
+
+namespace DxPtr {
+    template<typename T>
+    class omni_buffer;
+
+    namespace detail {
+        template<typename E>
+        class omni_buffer_weak;
+
+        template<typename E>
+        class omni_element_weak;
+
+        template<typename T>
+        inline constexpr bool is_mappable = is_trivially_relocatable_v<T> and alignof(T) <= 4096;
+
+        template<typename T>
+        class omni_buffer_block final : public omni_block_base {
+            // Below this many bytes, mremap saves little over realloc
+            static constexpr std::size_t map_threshold = 64 * 1024;
+
+            T* first = nullptr;
+            std::size_t count = 0;
+            std::size_t cap = 0;
+
+            // Bytes of the mapping, or 0 if the elements live on the heap
+            std::size_t mapped = 0;
+
+            ~omni_buffer_block() noexcept override = default;
+
+            void free_storage() noexcept {
+                if (first == nullptr)
+                    return;
+
+                #if DXPTR_HAS_MREMAP
+                if (mapped != 0) {
+                    ::munmap(first, mapped);
+                    mapped = 0;
+                    first = nullptr;
+                    return;
+                }
+                #endif
+
+                free_elements(first);
+                first = nullptr;
+            }
+
+            #if DXPTR_HAS_MREMAP
+            static std::size_t round_to_pages(std::size_t bytes) noexcept {
+                static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+                return round_up_to_nearest_multiple(bytes, page);
+            }
+
+            void grow_mapped(std::size_t newCap) {
+                std::size_t bytes = round_to_pages(newCap * sizeof(T));
+                void* memory;
+
+                if (mapped != 0) {
+                    memory = ::mremap(first, mapped, bytes, MREMAP_MAYMOVE);
+                } else {
+                    memory = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                    if (memory != MAP_FAILED)
+                        uninitialized_relocate(first, first + count, static_cast<T*>(memory));
+                }
+
+                if (memory == MAP_FAILED)
+                    throw std::bad_alloc();
+
+                if (mapped == 0)
+                    free_elements(first);
+
+                first = static_cast<T*>(memory);
+                cap = bytes / sizeof(T);
+                mapped = bytes;
+            }
+            #endif
+
+            void grow_to(std::size_t newCap) {
+                if (newCap > std::numeric_limits<std::size_t>::max() / sizeof(T))
+                    throw std::bad_array_new_length();
+
+                #if DXPTR_HAS_MREMAP
+                if constexpr (is_mappable<T>) {
+                    if (newCap * sizeof(T) >= map_threshold) {
+                        grow_mapped(newCap);
+                        return;
+                    }
+                }
+                #endif
+
+                if constexpr (is_reallocatable<T>) {
+                    if (first != nullptr) {
+                        void* memory = std::realloc(static_cast<void*>(first), newCap * sizeof(T));
+
+                        if (memory == nullptr)
+                            throw std::bad_alloc();
+
+                        first = static_cast<T*>(memory);
+                        cap = newCap;
+                        return;
+                    }
+                }
+
+                T* elements = allocate_elements<T>(newCap);
+
+                if constexpr (is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+                    uninitialized_relocate(first, first + count, elements);
+                } else {
+                    // Copy so the buffer is untouched if a constructor throws
+                    try {
+                        std::uninitialized_copy(first, first + count, elements);
+                    } catch (...) {
+                        free_elements(elements);
+                        throw;
+                    }
+
+                    std::destroy(first, first + count);
+                }
+
+                free_storage();
+
+                first = elements;
+                cap = newCap;
+            }
+
+            std::size_t next_capacity(std::size_t needed) const noexcept {
+                return std::max({ needed, cap * 2, std::size_t(4) });
+            }
+
+            public:
+            // The stored pointer is the block itself, the elements are looked up through it
+            omni_buffer_block() : omni_block_base(reinterpret_cast<uintptr_t>(this)) { }
+
+            T* data() const noexcept { return first; }
+            std::size_t size() const noexcept { return count; }
+            std::size_t capacity() const noexcept { return cap; }
+            bool is_mapped() const noexcept { return mapped != 0; }
+
+            void reserve(std::size_t newCap) {
+                if (newCap > cap)
+                    grow_to(newCap);
+            }
+
+            template<typename... Args>
+            T& emplace_back(Args&&... args) {
+                if (count == cap) {
+                    // Constructed first, since args may refer into the buffer
+                    T staged(std::forward<Args>(args)...);
+
+                    grow_to(next_capacity(count + 1));
+                    return *::new(first + count++) T(std::move(staged));
+                }
+
+                return *::new(first + count++) T(std::forward<Args>(args)...);
+            }
+
+            void pop_back() noexcept {
+                std::destroy_at(first + --count);
+            }
+
+            void resize(std::size_t newCount) {
+                if (newCount < count) {
+                    std::destroy(first + newCount, first + count);
+                } else if (newCount > count) {
+                    if (newCount > cap)
+                        grow_to(std::max(newCount, next_capacity(newCount)));
+
+                    std::uninitialized_value_construct(first + count, first + newCount);
+                }
+
+                count = newCount;
+            }
+
+            void clear() noexcept {
+                std::destroy(first, first + count);
+                count = 0;
+            }
+
+            // Views see an empty buffer from here on
+            void call_deleter() noexcept override {
+                clear();
+                free_storage();
+                cap = 0;
+            }
+
+            void delete_allocation() noexcept override {
+                omni_buffer_block* alloc = this;
+
+                alloc->~omni_buffer_block();
+                ::operator delete(alloc, sizeof(omni_buffer_block));
+            }
+        };
+
+        // Counted, non-owning handle to a whole buffer. E is T for refs and const T for views.
+        template<typename E>
+        class omni_buffer_weak {
+            using value_t = std::remove_const_t<E>;
+            using block_t = omni_buffer_block<value_t>;
+
+            block_t* control = nullptr;
+
+            explicit omni_buffer_weak(block_t* block) noexcept : control(block) {
+                if (control != nullptr)
+                    control->increment();
+            }
+
+            public:
+            using element_type = E;
+            using pointer = E*;
+            using iterator = E*;
+            using size_type = std::size_t;
+
+            constexpr omni_buffer_weak() noexcept = default;
+            constexpr omni_buffer_weak(std::nullptr_t) noexcept { }
+
+            omni_buffer_weak(const omni_buffer_weak& copy) : omni_buffer_weak(copy.control) { }
+
+            omni_buffer_weak(omni_buffer_weak&& move) noexcept
+            : control(std::exchange(move.control, nullptr)) { }
+
+            // From a ref to a view
+            template<typename E2>
+            requires (not std::is_same_v<E2, E> and std::convertible_to<E2*, E*>)
+            omni_buffer_weak(const omni_buffer_weak<E2>& copy) : omni_buffer_weak(copy.control) { }
+
+            omni_buffer_weak(const omni_buffer<value_t>& owner) : omni_buffer_weak(owner.control) { }
+
+            omni_buffer_weak& operator=(omni_buffer_weak copy) noexcept {
+                swap(copy);
+                return *this;
+            }
+
+            ~omni_buffer_weak() {
+                reset();
+            }
+
+            void reset() noexcept {
+                if (control != nullptr)
+                    std::exchange(control, nullptr)->decrement();
+            }
+
+            void swap(omni_buffer_weak& other) noexcept {
+                std::swap(control, other.control);
+            }
+
+            bool expired() const noexcept {
+                return control == nullptr or control->is_expired();
+            }
+
+            explicit operator bool() const noexcept {
+                return not expired();
+            }
+
+            // Looked up on every call, so never stale after growth. Null once expired.
+            pointer data() const noexcept {
+                return control == nullptr ? nullptr : control->data();
+            }
+
+            size_type size() const noexcept {
+                return control == nullptr ? 0 : control->size();
+            }
+
+            bool empty() const noexcept {
+                return size() == 0;
+            }
+
+            // Only valid until the buffer next grows
+            std::span<E> span() const noexcept {
+                return { data(), size() };
+            }
+
+            iterator begin() const noexcept { return data(); }
+            iterator end() const noexcept { return data() + size(); }
+
+            E& operator[](size_type index) const noexcept {
+                return data()[index];
+            }
+
+            omni_element_weak<E> element(size_type index) const {
+                return omni_element_weak<E>(control, index);
+            }
+
+            long use_count() const noexcept {
+                return control == nullptr ? 0 : static_cast<long>(control->use_count());
+            }
+
+            template<typename E2>
+            friend class omni_buffer_weak;
+
+            template<typename E2>
+            friend class omni_element_weak;
+        };
+
+        // Counted handle to one element by index. It resolves to null once the buffer
+        // expires or shrinks below the index, and to the new address after growth.
+        template<typename E>
+        class omni_element_weak {
+            using value_t = std::remove_const_t<E>;
+            using block_t = omni_buffer_block<value_t>;
+
+            block_t* control = nullptr;
+            std::size_t index = 0;
+
+            omni_element_weak(block_t* block, std::size_t index) : control(block), index(index) {
+                if (control != nullptr)
+                    control->increment();
+            }
+
+            public:
+            using element_type = E;
+            using pointer = E*;
+
+            constexpr omni_element_weak() noexcept = default;
+            constexpr omni_element_weak(std::nullptr_t) noexcept { }
+
+            omni_element_weak(const omni_element_weak& copy) : omni_element_weak(copy.control, copy.index) { }
+
+            omni_element_weak(omni_element_weak&& move) noexcept
+            : control(std::exchange(move.control, nullptr)), index(move.index) { }
+
+            template<typename E2>
+            requires (not std::is_same_v<E2, E> and std::convertible_to<E2*, E*>)
+            omni_element_weak(const omni_element_weak<E2>& copy) : omni_element_weak(copy.control, copy.index) { }
+
+            omni_element_weak& operator=(omni_element_weak copy) noexcept {
+                swap(copy);
+                return *this;
+            }
+
+            ~omni_element_weak() {
+                reset();
+            }
+
+            void reset() noexcept {
+                if (control != nullptr)
+                    std::exchange(control, nullptr)->decrement();
+            }
+
+            void swap(omni_element_weak& other) noexcept {
+                std::swap(control, other.control);
+                std::swap(index, other.index);
+            }
+
+            std::size_t get_index() const noexcept {
+                return index;
+            }
+
+            // False once the buffer expired or no longer holds the index
+            bool expired() const noexcept {
+                return control == nullptr or control->is_expired() or index >= control->size();
+            }
+
+            explicit operator bool() const noexcept {
+                return not expired();
+            }
+
+            pointer get() const noexcept {
+                return expired() ? nullptr : control->data() + index;
+            }
+
+            E& operator*() const noexcept {
+                return control->data()[index];
+            }
+
+            pointer operator->() const noexcept {
+                return control->data() + index;
+            }
+
+            template<typename E2>
+            friend class omni_element_weak;
+
+            template<typename E2>
+            friend class omni_buffer_weak;
+        };
+    }
+
+    template<typename T>
+    using omni_buffer_view = detail::omni_buffer_weak<const T>;
+
+    template<typename T>
+    using omni_buffer_ref = detail::omni_buffer_weak<T>;
+
+    template<typename T>
+    using omni_element_view = detail::omni_element_weak<const T>;
+
+    template<typename T>
+    using omni_element_ref = detail::omni_element_weak<T>;
+
+    // Owner of a growable buffer. Resetting it destroys the elements and expires every view.
+    // Apart from reset and the observers, a null buffer must not be used.
+    template<typename T>
+    class omni_buffer {
+        using block_t = detail::omni_buffer_block<T>;
+
+        block_t* control = nullptr;
+
+        explicit omni_buffer(block_t* block) noexcept : control(block) { }
+
+        public:
+        using element_type = T;
+        using value_type = T;
+        using pointer = T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+        using size_type = std::size_t;
+
+        constexpr omni_buffer() noexcept = default;
+        constexpr omni_buffer(std::nullptr_t) noexcept { }
+
+        omni_buffer(const omni_buffer&) = delete;
+        omni_buffer& operator=(const omni_buffer&) = delete;
+
+        omni_buffer(omni_buffer&& move) noexcept
+        : control(std::exchange(move.control, nullptr)) { }
+
+        omni_buffer& operator=(omni_buffer&& move) noexcept {
+            omni_buffer(std::move(move)).swap(*this);
+            return *this;
+        }
+
+        ~omni_buffer() {
+            reset();
+        }
+
+        void reset() noexcept {
+            if (control == nullptr)
+                return;
+
+            control->expire();
+            std::exchange(control, nullptr)->decrement();
+        }
+
+        void swap(omni_buffer& other) noexcept {
+            std::swap(control, other.control);
+        }
+
+        explicit operator bool() const noexcept {
+            return control != nullptr;
+        }
+
+        pointer data() const noexcept { return control == nullptr ? nullptr : control->data(); }
+        size_type size() const noexcept { return control == nullptr ? 0 : control->size(); }
+        size_type capacity() const noexcept { return control == nullptr ? 0 : control->capacity(); }
+        bool empty() const noexcept { return size() == 0; }
+
+        // Whether the elements currently live in a mapping grown with mremap
+        bool is_mapped() const noexcept { return control != nullptr and control->is_mapped(); }
+
+        iterator begin() noexcept { return data(); }
+        iterator end() noexcept { return data() + size(); }
+        const_iterator begin() const noexcept { return data(); }
+        const_iterator end() const noexcept { return data() + size(); }
+
+        std::span<T> span() const noexcept { return { data(), size() }; }
+
+        T& operator[](size_type index) const noexcept {
+            return control->data()[index];
+        }
+
+        void reserve(size_type newCap) { control->reserve(newCap); }
+        void resize(size_type newCount) { control->resize(newCount); }
+        void clear() noexcept { control->clear(); }
+        void pop_back() noexcept { control->pop_back(); }
+
+        void push_back(const T& value) { control->emplace_back(value); }
+        void push_back(T&& value) { control->emplace_back(std::move(value)); }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            return control->emplace_back(std::forward<Args>(args)...);
+        }
+
+        omni_element_ref<T> element(size_type index) const {
+            return omni_buffer_ref<T>(*this).element(index);
+        }
+
+        long use_count() const noexcept {
+            return control == nullptr ? 0 : static_cast<long>(control->use_count());
+        }
+
+        template<typename T2>
+        friend omni_buffer<T2> make_omni_buffer();
+
+        template<typename E>
+        friend class detail::omni_buffer_weak;
+    };
+
+    template<typename T>
+    omni_buffer<T> make_omni_buffer() {
+        return omni_buffer<T>(new detail::omni_buffer_block<T>());
+    }
+
+    // Starts with size value-initialized elements
+    template<typename T>
+    requires std::default_initializable<T>
+    omni_buffer<T> make_omni_buffer(std::size_t size) {
+        auto buffer = make_omni_buffer<T>();
+        buffer.resize(size);
+
+        return buffer;
+    }
+}
@@ -0,0 +1,483 @@
+#pragma once
+
+#include "OmniRegion.hpp"
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Binary images of object graphs built from omni_ptr<T> owners and omni_ref<T>/omni_view<T>
+// cross-links, for restarting without rebuilding the graph from scratch.
+//
+// Node types list their fields once, in a visit hook used both for saving and loading:
+//
+//     template<typename Archive>
+//     void visit(Archive& archive) { archive(value, name, children, sibling); }
+//
+// Fields may be trivially copyable values, owners, refs and views of T, and strings or
+// vectors of those. Raw pointer fields are rejected at compile time, since an address
+// means nothing after loading. Every node must be reachable from the root through
+// owners. In the image, owner and view edges are node indices.
+//
+// Loading default-constructs every node in one omni_region sized for the whole graph,
+// then reads the fields back, moving each node into its owner and pointing views at the
+// new nodes. Images use the native byte order.
+
+namespace DxPtr {
+    template<typename T>
+    class omni_graph;
+
+    namespace detail {
+        struct graph_header {
+            static constexpr std::uint64_t expected_magic = 0x6f6d6e6967726170; // "omnigrap"
+            static constexpr std::uint32_t current_version = 1;
+
+            std::uint64_t magic;
+            std::uint32_t version;
+            std::uint32_t reserved;
+            std::uint64_t nodeCount;
+            std::uint64_t payloadSize;
+        };
+
+        // Index 0 stands for a null edge, so node i is stored as i + 1
+        inline constexpr std::uint64_t null_edge = 0;
+
+        template<typename T>
+        T& visit_mutable(const T& node) noexcept {
+            return const_cast<T&>(node);
+        }
+
+        // Numbers every node reachable through owners, in breadth-first order
+        template<typename T>
+        class graph_indexer {
+            std::vector<const T*> nodes;
+            std::unordered_map<const T*, std::uint64_t> indices;
+
+            void field(const DxPtr::omni_ptr<T>& owner) {
+                if (owner != nullptr and indices.emplace(owner.get(), nodes.size()).second)
+                    nodes.push_back(owner.get());
+            }
+
+            template<typename U>
+            void field(const std::vector<U>& items) {
+                for (const U& item : items)
+                    field(item);
+            }
+
+            template<typename U>
+            void field(const U&) noexcept { }
+
+            public:
+            explicit graph_indexer(const DxPtr::omni_ptr<T>& root) {
+                field(root);
+
+                // nodes grows while it is walked, so this never recurses
+                for (std::size_t i = 0; i < nodes.size(); i++)
+                    visit_mutable(*nodes[i]).visit(*this);
+            }
+
+            template<typename... Fields>
+            void operator()(Fields&... fields) {
+                (field(fields), ...);
+            }
+
+            const std::vector<const T*>& get_nodes() const noexcept {
+                return nodes;
+            }
+
+            std::uint64_t edge_to(const T* node) const {
+                if (node == nullptr)
+                    return null_edge;
+
+                auto it = indices.find(node);
+
+                if (it == indices.end())
+                    throw std::runtime_error("omni graph view refers to an object outside the graph");
+
+                return it->second + 1;
+            }
+        };
+
+        template<typename T>
+        class graph_writer {
+            std::vector<std::byte>& out;
+            const graph_indexer<T>& index;
+
+            void write(const void* bytes, std::size_t size) {
+                const auto* first = static_cast<const std::byte*>(bytes);
+                out.insert(out.end(), first, first + size);
+            }
+
+            void write_u64(std::uint64_t value) {
+                write(&value, sizeof(value));
+            }
+
+            void field(const DxPtr::omni_ptr<T>& owner) {
+                write_u64(index.edge_to(owner.get()));
+            }
+
+            // Expired views are saved as null
+            void field(const DxPtr::omni_ref<T>& ref) {
+                write_u64(index.edge_to(ref.expired() ? nullptr : ref.get()));
+            }
+
+            void field(const DxPtr::omni_view<T>& view) {
+                write_u64(index.edge_to(view.expired() ? nullptr : view.get()));
+            }
+
+            template<typename C>
+            void field(const std::basic_string<C>& text) {
+                write_u64(text.size());
+                write(text.data(), text.size() * sizeof(C));
+            }
+
+            template<typename U>
+            void field(const std::vector<U>& items) {
+                write_u64(items.size());
+
+                for (const U& item : items)
+                    field(item);
+            }
+
+            template<typename U>
+            void field(const U& value) {
+                static_assert(not std::is_pointer_v<U> and not std::is_member_pointer_v<U>, "Raw pointers in omni graph nodes cannot be saved; use omni_ref or omni_view");
+                static_assert(std::is_trivially_copyable_v<U>, "Unsupported field type in omni graph visit");
+                write(&value, sizeof(U));
+            }
+
+            public:
+            graph_writer(std::vector<std::byte>& out, const graph_indexer<T>& index) noexcept
+            : out(out), index(index) { }
+
+            template<typename... Fields>
+            void operator()(Fields&... fields) {
+                (field(fields), ...);
+            }
+        };
+
+        template<typename T>
+        class graph_reader {
+            std::span<const std::byte> payload;
+            std::size_t position = 0;
+
+            // Owners not yet moved into their parent, and refs to every node for rewiring views
+            std::vector<DxPtr::omni_ptr<T>>& unowned;
+            const std::vector<DxPtr::omni_ref<T>>& nodes;
+
+            [[noreturn]] static void corrupt(const char* what) {
+                throw std::runtime_error(std::string("Corrupt omni graph image: ") + what);
+            }
+
+            void read(void* bytes, std::size_t size) {
+                if (size > payload.size() - position)
+                    corrupt("truncated");
+
+                std::memcpy(bytes, payload.data() + position, size);
+                position += size;
+            }
+
+            std::uint64_t read_u64() {
+                std::uint64_t value;
+                read(&value, sizeof(value));
+                return value;
+            }
+
+            // Guards resize() against lengths no payload could hold
+            std::size_t read_length(std::size_t minimumItemSize) {
+                std::uint64_t length = read_u64();
+
+                if (minimumItemSize != 0 and length > (payload.size() - position) / minimumItemSize)
+                    corrupt("length past the end");
+
+                return static_cast<std::size_t>(length);
+            }
+
+            const DxPtr::omni_ref<T>* read_edge() {
+                std::uint64_t edge = read_u64();
+
+                if (edge == null_edge)
+                    return nullptr;
+
+                if (edge > nodes.size())
+                    corrupt("edge to a missing node");
+
+                return &nodes[edge - 1];
+            }
+
+            void field(DxPtr::omni_ptr<T>& owner) {
+                std::uint64_t edge = read_u64();
+
+                if (edge == null_edge) {
+                    owner.reset();
+                    return;
+                }
+
+                if (edge > unowned.size() or unowned[edge - 1] == nullptr)
+                    corrupt("node owned twice");
+
+                owner = std::move(unowned[edge - 1]);
+            }
+
+            void field(DxPtr::omni_ref<T>& ref) {
+                if (const DxPtr::omni_ref<T>* target = read_edge())
+                    ref = *target;
+                else
+                    ref.reset();
+            }
+
+            void field(DxPtr::omni_view<T>& view) {
+                if (const DxPtr::omni_ref<T>* target = read_edge())
+                    view = *target;
+                else
+                    view.reset();
+            }
+
+            template<typename C>
+            void field(std::basic_string<C>& text) {
+                text.resize(read_length(sizeof(C)));
+                read(text.data(), text.size() * sizeof(C));
+            }
+
+            template<typename U>
+            void field(std::vector<U>& items) {
+                items.resize(read_length(1));
+
+                for (U& item : items)
+                    field(item);
+            }
+
+            template<typename U>
+            void field(U& value) {
+                static_assert(not std::is_pointer_v<U> and not std::is_member_pointer_v<U>, "Raw pointers in omni graph nodes cannot be saved; use omni_ref or omni_view");
+                static_assert(std::is_trivially_copyable_v<U>, "Unsupported field type in omni graph visit");
+                read(&value, sizeof(U));
+            }
+
+            public:
+            graph_reader(std::span<const std::byte> payload, std::vector<DxPtr::omni_ptr<T>>& unowned, const std::vector<DxPtr::omni_ref<T>>& nodes) noexcept
+            : payload(payload), unowned(unowned), nodes(nodes) { }
+
+            template<typename... Fields>
+            void operator()(Fields&... fields) {
+                (field(fields), ...);
+            }
+
+            bool at_end() const noexcept {
+                return position == payload.size();
+            }
+        };
+
+        class mapped_file {
+            void* memory = nullptr;
+            std::size_t size = 0;
+
+            public:
+            explicit mapped_file(const std::string& path) {
+                int fd = ::open(path.c_str(), O_RDONLY);
+
+                if (fd == -1)
+                    throw std::system_error(errno, std::generic_category(), "open");
+
+                struct stat info;
+
+                if (::fstat(fd, &info) == -1) {
+                    int error = errno;
+                    ::close(fd);
+                    throw std::system_error(error, std::generic_category(), "fstat");
+                }
+
+                size = static_cast<std::size_t>(info.st_size);
+
+                if (size != 0)
+                    memory = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                int error = errno;
+                ::close(fd);
+
+                if (memory == MAP_FAILED)
+                    throw std::system_error(error, std::generic_category(), "mmap");
+            }
+
+            mapped_file(const mapped_file&) = delete;
+            mapped_file& operator=(const mapped_file&) = delete;
+
+            ~mapped_file() {
+                if (memory != nullptr)
+                    ::munmap(memory, size);
+            }
+
+            std::span<const std::byte> bytes() const noexcept {
+                return { static_cast<const std::byte*>(memory), size };
+            }
+        };
+    }
+
+    template<typename T>
+    concept omni_graph_node = std::default_initializable<T> and requires(T& node, detail::graph_indexer<T>& archive) {
+        node.visit(archive);
+    };
+
+    // A loaded graph. Every node lives in its region, which ends with the graph,
+    // so views of nodes may outlive it but owners must not be moved out of it.
+    template<typename T>
+    class omni_graph {
+        std::unique_ptr<omni_region> arena;
+        omni_ptr<T> rootOwner;
+        std::size_t count = 0;
+
+        public:
+        omni_graph() = default;
+
+        omni_graph(omni_graph&&) noexcept = default;
+
+        omni_graph& operator=(omni_graph&& move) noexcept {
+            if (this == &move)
+                return *this;
+
+            // Tear down the old graph before its region, as the destructor does
+            rootOwner.reset();
+            arena.reset();
+
+            rootOwner = std::move(move.rootOwner);
+            arena = std::move(move.arena);
+            count = std::exchange(move.count, 0);
+
+            return *this;
+        }
+
+        ~omni_graph() {
+            // The whole graph hangs off the root, so it goes first
+            rootOwner.reset();
+        }
+
+        const omni_ptr<T>& root() const noexcept {
+            return rootOwner;
+        }
+
+        T* get() const noexcept { return rootOwner.get(); }
+        T& operator*() const noexcept { return *rootOwner; }
+        T* operator->() const noexcept { return rootOwner.get(); }
+
+        std::size_t node_count() const noexcept {
+            return count;
+        }
+
+        template<typename T2>
+        requires omni_graph_node<T2>
+        friend omni_graph<T2> load_omni_graph(std::span<const std::byte> image);
+    };
+
+    template<typename T>
+    requires omni_graph_node<T>
+    std::vector<std::byte> save_omni_graph(const omni_ptr<T>& root) {
+        detail::graph_indexer<T> index(root);
+        const auto& nodes = index.get_nodes();
+
+        std::vector<std::byte> image(sizeof(detail::graph_header));
+        detail::graph_writer<T> writer(image, index);
+
+        for (const T* node : nodes)
+            detail::visit_mutable(*node).visit(writer);
+
+        detail::graph_header header{};
+        header.magic = detail::graph_header::expected_magic;
+        header.version = detail::graph_header::current_version;
+        header.nodeCount = nodes.size();
+        header.payloadSize = image.size() - sizeof(header);
+
+        std::memcpy(image.data(), &header, sizeof(header));
+
+        return image;
+    }
+
+    template<typename T>
+    requires omni_graph_node<T>
+    void save_omni_graph(const omni_ptr<T>& root, const std::string& path) {
+        std::vector<std::byte> image = save_omni_graph(root);
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+        file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+
+        if (not file.flush())
+            throw std::system_error(std::make_error_code(std::errc::io_error), "Writing omni graph image");
+    }
+
+    // Throws std::runtime_error on a malformed image
+    template<typename T>
+    requires omni_graph_node<T>
+    omni_graph<T> load_omni_graph(std::span<const std::byte> image) {
+        detail::graph_header header;
+
+        if (image.size() < sizeof(header))
+            throw std::runtime_error("Corrupt omni graph image: truncated");
+
+        std::memcpy(&header, image.data(), sizeof(header));
+
+        if (header.magic != detail::graph_header::expected_magic or header.version != detail::graph_header::current_version)
+            throw std::runtime_error("Not an omni graph image");
+
+        auto payload = image.subspan(sizeof(header));
+
+        // Every node but the root is named by an owner edge, which bounds the count before anything is allocated
+        if (header.payloadSize != payload.size() or header.nodeCount > payload.size() / sizeof(std::uint64_t) + 1)
+            throw std::runtime_error("Corrupt omni graph image: bad header");
+
+        omni_graph<T> graph;
+        graph.count = static_cast<std::size_t>(header.nodeCount);
+
+        if (graph.count == 0)
+            return graph;
+
+        constexpr auto alignment = static_cast<std::size_t>(AlignmentPolicy::Default{}.template get_alignment<T>());
+        constexpr std::size_t stride = detail::round_up_to_nearest_multiple(AlignmentPolicy::get_stored_size<T, AlignmentPolicy::Default>(), alignment);
+
+        // One chunk for the whole graph, with room for the chunk header
+        graph.arena = std::make_unique<omni_region>(graph.count * stride + alignment + alignof(std::max_align_t));
+
+        std::vector<omni_ptr<T>> unowned;
+        std::vector<omni_ref<T>> nodes;
+
+        unowned.reserve(graph.count);
+        nodes.reserve(graph.count);
+
+        for (std::size_t i = 0; i < graph.count; i++) {
+            unowned.push_back(graph.arena->template make<T>());
+            nodes.emplace_back(unowned.back());
+        }
+
+        graph.rootOwner = std::move(unowned.front());
+
+        detail::graph_reader<T> reader(payload, unowned, nodes);
+
+        for (auto& node : nodes)
+            node->visit(reader);
+
+        if (not reader.at_end())
+            throw std::runtime_error("Corrupt omni graph image: trailing bytes");
+
+        for (const auto& owner : unowned) {
+            if (owner != nullptr)
+                throw std::runtime_error("Corrupt omni graph image: node without an owner");
+        }
+
+        return graph;
+    }
+
+    template<typename T>
+    requires omni_graph_node<T>
+    omni_graph<T> load_omni_graph(const std::string& path) {
+        detail::mapped_file file(path);
+        return load_omni_graph<T>(file.bytes());
+    }
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <functional>
+#include <tuple>
+
+// Lazily constructed omni objects. make_omni_lazy allocates the conjoined buffer up front
+// and keeps the constructor arguments in the control block, and T is only constructed on
+// first access through the owner or any view. Expiry works as usual, and an object that
+// was never accessed is never constructed.
+//
+// Like std::thread, arguments are stored by value. Pass std::ref to store a reference.
+//
+// T must opt in through lazy_construction<T>, since views of it then check for a pending
+// construction on every dereference.
+
+namespace DxPtr {
+    template<typename T, typename AP>
+    class omni_lazy;
+
+    namespace detail {
+        template<typename T, typename AP, typename... Args>
+        class omni_lazy_block final : public omni_block_base {
+            static constexpr std::size_t stored_alignment = static_cast<std::size_t>(AP{}.template get_alignment<T>());
+
+            alignas(stored_alignment) std::byte storage[AlignmentPolicy::get_stored_size<T, AP>()];
+
+            // Alive until T is constructed from it
+            union {
+                std::tuple<Args...> arguments;
+            };
+
+            template<typename... Ts>
+            omni_lazy_block(Ts&&... args)
+            : omni_block_base(reinterpret_cast<uintptr_t>(storage)), arguments(std::forward<Ts>(args)...) {
+                mark_pending();
+            }
+
+            ~omni_lazy_block() noexcept override { }
+
+            // A throwing constructor may leave the arguments moved from for the next attempt
+            void materialize() override {
+                std::apply([this](Args&... args) { ::new(storage) T(std::forward<Args>(args)...); }, arguments);
+                std::destroy_at(&arguments);
+            }
+
+            public:
+            template<typename... Ts>
+            static omni_lazy_block* make(Ts&&... args) {
+                constexpr auto alignment = std::align_val_t(alignof(omni_lazy_block));
+                void* buffer = aligned_allocator{}.allocate(alignment, sizeof(omni_lazy_block));
+
+                try {
+                    return ::new(buffer) omni_lazy_block(std::forward<Ts>(args)...);
+                } catch (...) {
+                    aligned_allocator{}.deallocate(buffer, alignment, sizeof(omni_lazy_block));
+                    throw;
+                }
+            }
+
+            // Address T lives at once constructed
+            T* get() noexcept { return reinterpret_cast<T*>(storage); }
+
+            // A never constructed object stays unconstructed, so that nothing
+            // materializes it later from arguments that are already gone
+            void call_deleter() noexcept override {
+                if (is_pending()) {
+                    std::destroy_at(&arguments);
+                    clear_pending();
+                } else
+                    std::launder(get())->~T();
+            }
+
+            void delete_allocation() noexcept override {
+                omni_lazy_block* alloc = this;
+
+                alloc->~omni_lazy_block();
+                aligned_allocator{}.deallocate(alloc, std::align_val_t(alignof(omni_lazy_block)), sizeof(omni_lazy_block));
+            }
+        };
+    }
+
+    // Owner of a lazily constructed T. Views minted from it are ordinary omni_view/omni_ref.
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    class omni_lazy : public omni_ptr<T, AP> {
+        using base_t = omni_ptr<T, AP>;
+
+        explicit omni_lazy(base_t&& owner) noexcept : base_t(std::move(owner)) { }
+
+        public:
+        using typename base_t::pointer;
+
+        constexpr omni_lazy() noexcept = default;
+        constexpr omni_lazy(std::nullptr_t) noexcept { }
+
+        omni_lazy(omni_lazy&&) noexcept = default;
+        omni_lazy& operator=(omni_lazy&&) noexcept = default;
+
+        // Constructs T now if nothing has accessed it yet
+        void construct() const {
+            if (auto* control = detail::get_control_block(*this))
+                control->materialize_if_pending();
+        }
+
+        bool is_constructed() const noexcept {
+            auto* control = detail::get_control_block(*this);
+            return control != nullptr and not control->is_pending();
+        }
+
+        pointer get() const {
+            construct();
+            return base_t::get();
+        }
+
+        T& operator*() const {
+            return *get();
+        }
+
+        pointer operator->() const {
+            return get();
+        }
+
+        template<typename T2, typename AP2, typename... Args>
+        requires (not std::is_array_v<T2> and std::constructible_from<T2, std::unwrap_ref_decay_t<Args>&&...>)
+        friend omni_lazy<T2, AP2> make_omni_lazy(Args&&... args);
+    };
+
+    template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+    requires (not std::is_array_v<T> and std::constructible_from<T, std::unwrap_ref_decay_t<Args>&&...>)
+    omni_lazy<T, AP> make_omni_lazy(Args&&... args) {
+        static_assert(lazy_construction<std::remove_cv_t<T>>, "Specialize DxPtr::lazy_construction<T> to make T lazily");
+
+        using block_t = detail::omni_lazy_block<T, AP, std::unwrap_ref_decay_t<Args>...>;
+
+        auto* block = block_t::make(std::forward<Args>(args)...);
+
+        return omni_lazy<T, AP>(detail::make_omni_ptr_raw<omni_ptr<T, AP>>(block->get(), block));
+    }
+}
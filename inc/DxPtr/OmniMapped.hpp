@@ -0,0 +1,234 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Memory-mapped files adopted by an omni owner. map_file returns an omni_mapped_file around
+// an omni_ptr<std::byte[]> whose deleter unmaps the file, and views of records inside the
+// mapping are made with the aliasing constructor. Those views expire when the owner unmaps the file, so readers get
+// zero-copy access without ever touching an unmapped page.
+
+namespace DxPtr {
+    enum class map_flags : unsigned {
+        read_only = 0,
+
+        // Writes go through to the file
+        read_write = 1,
+
+        // Writable, but writes stay private to this mapping
+        copy_on_write = 2,
+
+        // Fault in every page up front
+        populate = 4
+    };
+
+    constexpr map_flags operator|(map_flags lhs, map_flags rhs) noexcept {
+        return static_cast<map_flags>(static_cast<unsigned>(lhs) | static_cast<unsigned>(rhs));
+    }
+
+    constexpr bool operator&(map_flags lhs, map_flags rhs) noexcept {
+        return (static_cast<unsigned>(lhs) & static_cast<unsigned>(rhs)) != 0;
+    }
+
+    // Hints passed to madvise
+    enum class map_advice {
+        normal = MADV_NORMAL,
+        sequential = MADV_SEQUENTIAL,
+        random = MADV_RANDOM,
+        will_need = MADV_WILLNEED,
+        dont_need = MADV_DONTNEED,
+        #ifdef MADV_HUGEPAGE
+        huge_pages = MADV_HUGEPAGE,
+        #endif
+    };
+
+    class omni_mapped_file;
+
+    omni_mapped_file map_file(const std::string& path, map_flags flags = map_flags::read_only);
+
+    namespace detail {
+        struct munmap_deleter {
+            std::size_t length;
+
+            void operator()(std::byte* mapping) const noexcept {
+                if (mapping != nullptr)
+                    ::munmap(mapping, length);
+            }
+
+            // Spelled out for omni_ptr<std::byte[]>'s deleter requirements
+            void operator()(std::byte (*mapping)[]) const noexcept {
+                (*this)(*mapping);
+            }
+        };
+    }
+
+    // Owner of a whole mapping. It wraps rather than derives from omni_ptr<std::byte[]>, so
+    // its size cannot go stale. into_owner() hands the mapping over to a plain owner.
+    class omni_mapped_file {
+        using owner_t = omni_ptr<std::byte[]>;
+
+        owner_t owner;
+        std::size_t length = 0;
+
+        omni_mapped_file(std::byte* mapping, std::size_t length)
+        : owner(mapping, detail::munmap_deleter{ length }), length(length) { }
+
+        void check_record(std::size_t offset, std::size_t size, std::size_t alignment) const {
+            if (offset > length or size > length - offset)
+                throw std::out_of_range("Record past the end of the mapping");
+
+            if (reinterpret_cast<std::uintptr_t>(get() + offset) % alignment != 0)
+                throw std::invalid_argument("Misaligned record in mapping");
+        }
+
+        public:
+        using pointer = std::byte*;
+
+        constexpr omni_mapped_file() noexcept = default;
+        constexpr omni_mapped_file(std::nullptr_t) noexcept { }
+
+        omni_mapped_file(omni_mapped_file&& move) noexcept
+        : owner(std::move(move.owner)), length(std::exchange(move.length, 0)) { }
+
+        // Unmaps the file this held before taking over the other one
+        omni_mapped_file& operator=(omni_mapped_file&& move) noexcept {
+            if (this == &move)
+                return *this;
+
+            reset();
+            owner.swap(move.owner);
+            std::swap(length, move.length);
+
+            return *this;
+        }
+
+        // Unmaps the file and expires every record view
+        void reset() noexcept {
+            owner.reset();
+            length = 0;
+        }
+
+        // Hands the mapping to a plain owner, which still unmaps it, and leaves this empty
+        owner_t into_owner() noexcept {
+            length = 0;
+            return std::move(owner);
+        }
+
+        pointer get() const noexcept {
+            return owner.get();
+        }
+
+        std::size_t size() const noexcept {
+            return length;
+        }
+
+        std::span<std::byte> bytes() const noexcept {
+            return { get(), length };
+        }
+
+        long use_count() const noexcept {
+            return owner.use_count();
+        }
+
+        explicit operator bool() const noexcept {
+            return owner != nullptr;
+        }
+
+        friend bool operator==(const omni_mapped_file& file, std::nullptr_t) noexcept {
+            return file.owner == nullptr;
+        }
+
+        // View of the record of type R starting offset bytes into the file.
+        // Throws if it does not fit in the mapping or is misaligned.
+        template<typename R>
+        requires std::is_trivially_copyable_v<R>
+        omni_view<R> view(std::size_t offset) const {
+            check_record(offset, sizeof(R), alignof(R));
+            return omni_view<R>(owner, reinterpret_cast<const R*>(get() + offset));
+        }
+
+        // Writable record, only for mappings made with read_write or copy_on_write
+        template<typename R>
+        requires std::is_trivially_copyable_v<R>
+        omni_ref<R> ref(std::size_t offset) const {
+            check_record(offset, sizeof(R), alignof(R));
+            return omni_ref<R>(owner, reinterpret_cast<R*>(get() + offset));
+        }
+
+        // Applies to the pages covering [offset, offset + count), the whole file by default
+        void advise(map_advice advice, std::size_t offset = 0, std::size_t count = std::size_t(-1)) const {
+            if (get() == nullptr or offset >= length)
+                return;
+
+            static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+
+            count = std::min(count, length - offset);
+
+            std::size_t first = offset / page * page;
+            std::size_t last = offset + count;
+
+            if (::madvise(get() + first, last - first, static_cast<int>(advice)) == -1)
+                throw std::system_error(errno, std::generic_category(), "madvise");
+        }
+
+        friend omni_mapped_file map_file(const std::string& path, map_flags flags);
+    };
+
+    // Empty files give an empty mapping with no owner
+    inline omni_mapped_file map_file(const std::string& path, map_flags flags) {
+        bool writable = flags & (map_flags::read_write | map_flags::copy_on_write);
+        bool shared = not (flags & map_flags::copy_on_write);
+
+        int fd = ::open(path.c_str(), (flags & map_flags::read_write) ? O_RDWR : O_RDONLY);
+
+        if (fd == -1)
+            throw std::system_error(errno, std::generic_category(), "open");
+
+        struct stat info;
+
+        if (::fstat(fd, &info) == -1) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+
+        auto length = static_cast<std::size_t>(info.st_size);
+
+        if (length == 0) {
+            ::close(fd);
+            return omni_mapped_file();
+        }
+
+        int protection = PROT_READ | (writable ? PROT_WRITE : 0);
+        int mapping = shared ? MAP_SHARED : MAP_PRIVATE;
+
+        #ifdef MAP_POPULATE
+        if (flags & map_flags::populate)
+            mapping |= MAP_POPULATE;
+        #endif
+
+        void* memory = ::mmap(nullptr, length, protection, mapping, fd, 0);
+        int error = errno;
+
+        // The mapping keeps the file alive on its own
+        ::close(fd);
+
+        if (memory == MAP_FAILED)
+            throw std::system_error(error, std::generic_category(), "mmap");
+
+        try {
+            return omni_mapped_file(static_cast<std::byte*>(memory), length);
+        } catch (...) {
+            ::munmap(memory, length);
+            throw;
+        }
+    }
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <execution>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+// Parallel construction and destruction of large omni arrays.
+// make_omni<T[]>(policy, n) value-initializes the elements in chunks spread over the
+// execution policy, and the resulting block destroys them the same way once expired.
+// With libstdc++, parallel policies need TBB, which CMake links when it is found.
+
+namespace DxPtr {
+    namespace detail {
+        // Splits [0, count) into a few chunks per hardware thread, never smaller than min_chunk
+        class parallel_chunks {
+            static constexpr std::size_t min_chunk = 256;
+            static constexpr std::size_t chunks_per_thread = 4;
+
+            std::size_t count;
+            std::size_t chunkSize;
+            std::vector<std::size_t> indices;
+
+            public:
+            explicit parallel_chunks(std::size_t count) : count(count) {
+                std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+                std::size_t target = threads * chunks_per_thread;
+
+                chunkSize = std::max(min_chunk, (count + target - 1) / target);
+                indices.resize((count + chunkSize - 1) / chunkSize);
+
+                for (std::size_t i = 0; i < indices.size(); i++)
+                    indices[i] = i;
+            }
+
+            std::size_t size() const noexcept { return indices.size(); }
+
+            auto begin() const noexcept { return indices.begin(); }
+            auto end() const noexcept { return indices.end(); }
+
+            std::size_t first(std::size_t chunk) const noexcept { return chunk * chunkSize; }
+            std::size_t last(std::size_t chunk) const noexcept { return std::min(count, (chunk + 1) * chunkSize); }
+        };
+
+        template<typename T, typename AP, typename Policy>
+        class omni_parallel_array_block final : public omni_block_base {
+            using element_type = std::remove_extent_t<T>;
+
+            static constexpr std::size_t align_elem = static_cast<std::size_t>(AP{}.template get_alignment<element_type>());
+
+            [[no_unique_address]] Policy policy;
+            std::size_t count;
+
+            omni_parallel_array_block(const Policy& policy, element_type* elements, std::size_t count) noexcept
+            : omni_block_base(reinterpret_cast<uintptr_t>(elements)), policy(policy), count(count) { }
+
+            ~omni_parallel_array_block() noexcept override = default;
+
+            static constexpr std::align_val_t get_alignment() noexcept {
+                return std::align_val_t(std::max(alignof(omni_parallel_array_block), align_elem));
+            }
+
+            static constexpr std::size_t get_elements_offset() noexcept {
+                return round_up_to_nearest_multiple(sizeof(omni_parallel_array_block), align_elem);
+            }
+
+            static std::size_t get_total_size(std::size_t count) {
+                if (count > (std::numeric_limits<std::size_t>::max() - get_elements_offset()) / sizeof(element_type))
+                    throw std::bad_array_new_length();
+
+                return get_elements_offset() + count * sizeof(element_type);
+            }
+
+            public:
+            element_type* elements() noexcept {
+                return std::launder(reinterpret_cast<element_type*>(reinterpret_cast<std::byte*>(this) + get_elements_offset()));
+            }
+
+            // If any constructor throws, every element already constructed is destroyed again,
+            // the buffer is freed, and the first exception is rethrown
+            static omni_parallel_array_block* make(const Policy& policy, std::size_t count) {
+                std::size_t totalSize = get_total_size(count);
+                auto* buffer = static_cast<std::byte*>(aligned_allocator{}.allocate(get_alignment(), totalSize));
+                auto* stored = reinterpret_cast<element_type*>(buffer + get_elements_offset());
+
+                std::optional<parallel_chunks> chunks;
+                std::unique_ptr<std::atomic<bool>[]> built;
+
+                try {
+                    chunks.emplace(count);
+                    built = std::make_unique<std::atomic<bool>[]>(chunks->size());
+                    std::vector<std::exception_ptr> failures(chunks->size());
+
+                    // Exceptions escaping a parallel algorithm terminate, so each chunk catches its own.
+                    // A failed chunk cleans up after itself and is never marked built.
+                    std::for_each(policy, chunks->begin(), chunks->end(), [&](std::size_t chunk) {
+                        try {
+                            std::uninitialized_value_construct(stored + chunks->first(chunk), stored + chunks->last(chunk));
+                            built[chunk].store(true, std::memory_order_release);
+                        } catch (...) {
+                            failures[chunk] = std::current_exception();
+                        }
+                    });
+
+                    auto failed = std::find_if(failures.begin(), failures.end(), [](const std::exception_ptr& e) { return e != nullptr; });
+
+                    if (failed != failures.end())
+                        std::rethrow_exception(*failed);
+                } catch (...) {
+                    // Also reached when the dispatch itself throws after running some chunks
+                    if (built != nullptr) {
+                        for (std::size_t chunk = 0; chunk < chunks->size(); chunk++) {
+                            if (built[chunk].load(std::memory_order_acquire))
+                                std::destroy(stored + chunks->first(chunk), stored + chunks->last(chunk));
+                        }
+                    }
+
+                    aligned_allocator{}.deallocate(buffer, get_alignment(), totalSize);
+                    throw;
+                }
+
+                return ::new(buffer) omni_parallel_array_block(policy, stored, count);
+            }
+
+            std::size_t array_extent() const noexcept override {
+                return count;
+            }
+
+            bool knows_extent() const noexcept override {
+                return true;
+            }
+
+            void call_deleter() noexcept override {
+                if constexpr (not std::is_trivially_destructible_v<element_type>) {
+                    element_type* stored = elements();
+                    std::optional<parallel_chunks> chunks;
+                    std::unique_ptr<std::atomic<bool>[]> destroyed;
+
+                    // Without memory for the chunk list, destroy on this thread instead
+                    try {
+                        chunks.emplace(count);
+                        destroyed = std::make_unique<std::atomic<bool>[]>(chunks->size());
+                    } catch (...) {
+                        std::destroy(stored, stored + count);
+                        return;
+                    }
+
+                    // The dispatch itself may throw bad_alloc after running some chunks,
+                    // and the rest are then destroyed on this thread
+                    try {
+                        std::for_each(policy, chunks->begin(), chunks->end(), [&](std::size_t chunk) {
+                            std::destroy(stored + chunks->first(chunk), stored + chunks->last(chunk));
+                            destroyed[chunk].store(true, std::memory_order_release);
+                        });
+                    } catch (...) {
+                        for (std::size_t chunk = 0; chunk < chunks->size(); chunk++) {
+                            if (not destroyed[chunk].load(std::memory_order_acquire))
+                                std::destroy(stored + chunks->first(chunk), stored + chunks->last(chunk));
+                        }
+                    }
+                }
+            }
+
+            void delete_allocation() noexcept override {
+                omni_parallel_array_block* alloc = this;
+                std::size_t totalSize = get_elements_offset() + count * sizeof(element_type);
+
+                alloc->~omni_parallel_array_block();
+                aligned_allocator{}.deallocate(alloc, get_alignment(), totalSize);
+            }
+        };
+    }
+
+    // Elements are value-initialized across the policy and destroyed across it once expired
+    template<typename T, typename AP = AlignmentPolicy::Default, typename Policy>
+    requires (std::is_unbounded_array_v<T> and std::is_execution_policy_v<std::remove_cvref_t<Policy>>)
+    omni_ptr<T, AP> make_omni(Policy&& policy, std::size_t size) {
+        using block_t = detail::omni_parallel_array_block<T, AP, std::remove_cvref_t<Policy>>;
+
+        auto* block = block_t::make(policy, size);
+
+        return detail::make_omni_ptr_raw<omni_ptr<T, AP>>(block->elements(), block);
+    }
+}
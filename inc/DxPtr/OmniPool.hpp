@@ -0,0 +1,224 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+#include <cstring>
+
+// Object pools recycle the conjoined buffers of one type instead of round-tripping
+// every make_omni through aligned_alloc and free. pool.make() returns an ordinary
+// omni_ptr, and the buffer goes back to the pool once the owner and every view
+// have released it.
+
+namespace DxPtr {
+    namespace detail {
+        // Freelists of equally sized buffers, shared by a pool and every block it made.
+        // The pool holds one reference and every buffer in use holds another,
+        // so blocks outliving their pool can still hand their buffer back.
+        //
+        // Only the thread that created the pool takes buffers. Buffers released on that
+        // thread go straight onto its local list, buffers released on any other thread
+        // are pushed onto a lock-free stack that the home thread takes in one batch.
+        class omni_pool_state {
+            struct free_node {
+                free_node* next;
+            };
+
+            std::align_val_t alignment;
+            std::size_t size;
+            std::uint64_t homeThread;
+
+            // Only touched by the home thread
+            free_node* localFree = nullptr;
+            std::size_t localCount = 0;
+            bool closed = false;
+
+            std::atomic<free_node*> remoteFree = nullptr;
+            std::atomic<std::size_t> references = 1;
+
+            static void free_all(free_node* list) noexcept {
+                while (list != nullptr) {
+                    free_node* next = list->next;
+                    aligned_free(list);
+                    list = next;
+                }
+            }
+
+            void push_local(void* buffer) noexcept {
+                localFree = ::new(buffer) free_node{ localFree };
+                localCount++;
+            }
+
+            void push_remote(void* buffer) noexcept {
+                free_node* node = ::new(buffer) free_node{ remoteFree.load(std::memory_order_relaxed) };
+
+                while (not remoteFree.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) { }
+            }
+
+            // Moves everything other threads returned onto the local list
+            void collect_remote() noexcept {
+                free_node* batch = remoteFree.exchange(nullptr, std::memory_order_acquire);
+
+                while (batch != nullptr) {
+                    free_node* next = batch->next;
+                    push_local(batch);
+                    batch = next;
+                }
+            }
+
+            void* allocate_fresh(bool prefault) {
+                void* buffer = aligned_alloc(alignment, size);
+
+                if (buffer == nullptr)
+                    throw std::bad_alloc();
+
+                // Touch every page now rather than on first use
+                if (prefault)
+                    std::memset(buffer, 0, size);
+
+                return buffer;
+            }
+
+            void release() noexcept {
+                if (references.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    return;
+
+                // The pool is gone, so nothing else can reach the remote list
+                free_all(remoteFree.exchange(nullptr, std::memory_order_acquire));
+                delete this;
+            }
+
+            public:
+            omni_pool_state(std::align_val_t alignment, std::size_t size)
+            : alignment(alignment)
+            , size(std::max(size, sizeof(free_node)))
+            , homeThread(biased_thread::acquire_current_id()) { }
+
+            omni_pool_state(const omni_pool_state&) = delete;
+            omni_pool_state& operator=(const omni_pool_state&) = delete;
+
+            void* take() {
+                if (localFree == nullptr)
+                    collect_remote();
+
+                void* buffer;
+
+                if (localFree != nullptr) {
+                    buffer = localFree;
+                    localFree = localFree->next;
+                    localCount--;
+                } else {
+                    buffer = allocate_fresh(false);
+                }
+
+                references.fetch_add(1, std::memory_order_relaxed);
+                return buffer;
+            }
+
+            void give(void* buffer) noexcept {
+                if (biased_thread::current_id() == homeThread and not closed)
+                    push_local(buffer);
+                else
+                    push_remote(buffer);
+
+                release();
+            }
+
+            void reserve(std::size_t count, bool prefault) {
+                collect_remote();
+
+                while (localCount < count)
+                    push_local(allocate_fresh(prefault));
+            }
+
+            std::size_t available() const noexcept {
+                return localCount;
+            }
+
+            std::size_t in_use() const noexcept {
+                return references.load(std::memory_order_acquire) - 1;
+            }
+
+            // Called by the pool on destruction, frees every idle buffer
+            void close() noexcept {
+                closed = true;
+
+                free_all(localFree);
+                free_all(remoteFree.exchange(nullptr, std::memory_order_acquire));
+
+                localFree = nullptr;
+                localCount = 0;
+
+                release();
+            }
+        };
+
+        class omni_pool_allocator {
+            omni_pool_state* state;
+
+            public:
+            explicit omni_pool_allocator(omni_pool_state* state) noexcept : state(state) { }
+
+            void* allocate(std::align_val_t, std::size_t) {
+                return state->take();
+            }
+
+            void deallocate(void* buffer, std::align_val_t, std::size_t) noexcept {
+                state->give(buffer);
+            }
+        };
+    }
+
+    // Pool of conjoined buffers for omni_ptr<T, AP>.
+    // make() and reserve() must be called on the thread that created the pool,
+    // which must also destroy it. Pointers it made may be released on any thread.
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    requires (not std::is_array_v<T> and AlignmentPolicy::interface<T, AP>)
+    class omni_pool {
+        using block_t = detail::omni_block<T, true, std::default_delete<T>, AP, detail::omni_pool_allocator>;
+
+        static constexpr auto info = block_t::get_conjoined_buffer_info(AlignmentPolicy::get_stored_size<T, AP>());
+
+        detail::omni_pool_state* state;
+
+        public:
+        omni_pool() : state(new detail::omni_pool_state(info.alignment, info.get_total_size())) { }
+
+        explicit omni_pool(std::size_t capacity, bool prefault = false) : omni_pool() {
+            reserve(capacity, prefault);
+        }
+
+        omni_pool(const omni_pool&) = delete;
+        omni_pool& operator=(const omni_pool&) = delete;
+
+        ~omni_pool() {
+            state->close();
+        }
+
+        template<typename... Args>
+        requires detail::correct_constructor_args<T, Args...>
+        omni_ptr<T, AP> make(Args&&... args) {
+            auto* block = block_t::make_conjoined_with(detail::omni_pool_allocator(state), std::forward<Args>(args)...);
+
+            return detail::make_omni_ptr_raw<omni_ptr<T, AP>>(block->get(), block);
+        }
+
+        // Ensures at least count idle buffers, optionally touching their pages up front
+        void reserve(std::size_t count, bool prefault = false) {
+            state->reserve(count, prefault);
+        }
+
+        // Idle buffers ready for make(), not counting returns from other threads not yet collected
+        std::size_t available() const noexcept {
+            return state->available();
+        }
+
+        // Buffers held by live owners or views
+        std::size_t in_use() const noexcept {
+            return state->in_use();
+        }
+
+        static constexpr std::size_t buffer_size() noexcept {
+            return info.get_total_size();
+        }
+    };
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+namespace DxPtr {
+    // Moves destruction of owned objects off the calling thread.
+    // omni_ptr::reset(reclaimer) marks the control block expired right away, so views
+    // observe the expiry immediately, and queues the block here. A background thread then
+    // runs call_deleter() and drops the owner's reference, which frees the allocation
+    // once no views are left.
+    class omni_reclaimer {
+        using clock = std::chrono::steady_clock;
+
+        struct node {
+            node* next;
+            detail::omni_block_base* block;
+            clock::time_point enqueued;
+        };
+
+        // Producers push onto a lock-free stack, the worker takes the whole stack at once
+        std::atomic<node*> head = nullptr;
+
+        std::atomic<std::uint64_t> enqueuedCount = 0;
+        std::atomic<std::uint64_t> reclaimedCount = 0;
+        std::atomic<std::int64_t> lastLagNs = 0;
+        std::atomic<std::int64_t> maxLagNs = 0;
+        std::atomic<bool> stopping = false;
+
+        // Bumped on every retire() and on shutdown to wake the worker
+        std::atomic<std::uint32_t> signal = 0;
+
+        std::thread worker;
+
+        static void reclaim(detail::omni_block_base* block) noexcept {
+            block->call_deleter();
+            block->decrement();
+        }
+
+        void record_lag(clock::time_point enqueued) noexcept {
+            std::int64_t lag = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - enqueued).count();
+            std::int64_t max = maxLagNs.load(std::memory_order_relaxed);
+
+            lastLagNs.store(lag, std::memory_order_relaxed);
+
+            while (lag > max and not maxLagNs.compare_exchange_weak(max, lag, std::memory_order_relaxed)) { }
+        }
+
+        // Returns whether anything was reclaimed
+        bool process_batch() noexcept {
+            node* batch = head.exchange(nullptr, std::memory_order_acquire);
+
+            if (batch == nullptr)
+                return false;
+
+            // Reverse so that blocks are reclaimed in retirement order
+            node* ordered = nullptr;
+
+            while (batch != nullptr) {
+                node* next = batch->next;
+                batch->next = ordered;
+                ordered = batch;
+                batch = next;
+            }
+
+            std::uint64_t count = 0;
+
+            while (ordered != nullptr) {
+                node* next = ordered->next;
+
+                reclaim(ordered->block);
+                record_lag(ordered->enqueued);
+                delete ordered;
+
+                ordered = next;
+                count++;
+            }
+
+            reclaimedCount.fetch_add(count, std::memory_order_release);
+            reclaimedCount.notify_all();
+
+            return true;
+        }
+
+        void run() noexcept {
+            while (true) {
+                std::uint32_t seen = signal.load(std::memory_order_acquire);
+
+                if (process_batch())
+                    continue;
+
+                if (stopping.load(std::memory_order_acquire) and head.load(std::memory_order_acquire) == nullptr)
+                    return;
+
+                signal.wait(seen, std::memory_order_acquire);
+            }
+        }
+
+        public:
+        omni_reclaimer() : worker([this] { run(); }) { }
+
+        omni_reclaimer(const omni_reclaimer&) = delete;
+        omni_reclaimer& operator=(const omni_reclaimer&) = delete;
+
+        // Reclaims everything still queued before returning
+        ~omni_reclaimer() {
+            stopping.store(true, std::memory_order_release);
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+
+            worker.join();
+        }
+
+        // Takes over an expired control block from omni_ptr::reset(reclaimer)
+        void retire(detail::omni_block_base* block) noexcept {
+            node* n = new (std::nothrow) node{ nullptr, block, clock::now() };
+
+            // Out of memory, so destroy inline instead of losing the block
+            if (n == nullptr) {
+                reclaim(block);
+                return;
+            }
+
+            // Counted before it is published, so a drain() that can see the node in the queue
+            // also waits for it. At worst drain() waits on a node that is about to be pushed.
+            enqueuedCount.fetch_add(1, std::memory_order_release);
+
+            n->next = head.load(std::memory_order_relaxed);
+
+            while (not head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) { }
+
+            signal.fetch_add(1, std::memory_order_release);
+            signal.notify_one();
+        }
+
+        template<typename T, typename AP>
+        void retire(omni_ptr<T, AP>&& owner) noexcept {
+            owner.reset(*this);
+        }
+
+        // Blocks until everything retired before the call has been reclaimed
+        void drain() noexcept {
+            std::uint64_t target = enqueuedCount.load(std::memory_order_acquire);
+            std::uint64_t done = reclaimedCount.load(std::memory_order_acquire);
+
+            while (done < target) {
+                reclaimedCount.wait(done, std::memory_order_acquire);
+                done = reclaimedCount.load(std::memory_order_acquire);
+            }
+        }
+
+        // Number of blocks retired but not yet reclaimed
+        std::size_t queue_depth() const noexcept {
+            std::uint64_t done = reclaimedCount.load(std::memory_order_acquire);
+            std::uint64_t queued = enqueuedCount.load(std::memory_order_acquire);
+
+            return queued > done ? static_cast<std::size_t>(queued - done) : 0;
+        }
+
+        std::uint64_t reclaimed_count() const noexcept {
+            return reclaimedCount.load(std::memory_order_acquire);
+        }
+
+        // Time between retire() and reclamation of the most recently reclaimed block
+        std::chrono::nanoseconds last_lag() const noexcept {
+            return std::chrono::nanoseconds(lastLagNs.load(std::memory_order_relaxed));
+        }
+
+        std::chrono::nanoseconds max_lag() const noexcept {
+            return std::chrono::nanoseconds(maxLagNs.load(std::memory_order_relaxed));
+        }
+    };
+}
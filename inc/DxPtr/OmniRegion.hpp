@@ -0,0 +1,245 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+
+// Regions bump-allocate objects out of large chunks for data with a shared lifetime,
+// such as everything belonging to one request or one frame. region.make<T>() returns
+// an ordinary omni_ptr. Ending the region destroys every object still alive in one
+// pass and frees the chunks wholesale.
+//
+// Control blocks are kept apart from the chunks in a small tombstone table that
+// survives the region, so views that outlive it still observe expiry. Owners that
+// outlive the region point into freed memory and must not be dereferenced, but
+// resetting or destroying them remains safe.
+
+namespace DxPtr {
+    namespace detail {
+        class omni_region_tombstones;
+
+        class omni_region_block final : public omni_block_base {
+            using destroy_fn = void (*)(void*) noexcept;
+
+            // Claimed by whichever of the owner and the end of the region gets there first,
+            // which may be on different threads
+            std::atomic<destroy_fn> destroy;
+            std::atomic<bool> destroyed = false;
+            omni_region_tombstones* table;
+
+            // Every block made by the region, newest first
+            omni_region_block* next;
+
+            ~omni_region_block() noexcept override = default;
+
+            public:
+            omni_region_block(void* stored, destroy_fn destroy, omni_region_tombstones* table, omni_region_block* next) noexcept
+            : omni_block_base(reinterpret_cast<uintptr_t>(stored)), destroy(destroy), table(table), next(next) { }
+
+            omni_region_block* get_next() const noexcept { return next; }
+
+            // Called by both the owner and the end of the region. The loser waits for the
+            // destructor to finish, so the region cannot free its chunks under it.
+            void call_deleter() noexcept override {
+                if (originalPointer == reinterpret_cast<uintptr_t>(nullptr))
+                    return;
+
+                if (destroy_fn claimed = destroy.exchange(nullptr, std::memory_order_acq_rel)) {
+                    claimed(reinterpret_cast<void*>(originalPointer));
+                    destroyed.store(true, std::memory_order_release);
+                    destroyed.notify_all();
+                    return;
+                }
+
+                destroyed.wait(false, std::memory_order_acquire);
+            }
+
+            // The slot stays in the table until the whole table goes away,
+            // so the region can still walk its blocks after the last reference drops
+            inline void delete_allocation() noexcept override;
+
+            friend class omni_region_tombstones;
+        };
+
+        // Slots for control blocks, shared by a region and every block it made
+        class omni_region_tombstones {
+            static constexpr std::size_t slab_slots = 256;
+
+            struct slab {
+                slab* next;
+                std::size_t used = 0;
+                alignas(omni_region_block) std::byte slots[slab_slots][sizeof(omni_region_block)];
+            };
+
+            slab* slabs = nullptr;
+
+            // One for the region and one per block
+            std::atomic<std::size_t> references = 1;
+
+            ~omni_region_tombstones() {
+                while (slabs != nullptr) {
+                    slab* next = slabs->next;
+
+                    for (std::size_t i = 0; i < slabs->used; i++)
+                        std::launder(reinterpret_cast<omni_region_block*>(slabs->slots[i]))->~omni_region_block();
+
+                    delete slabs;
+                    slabs = next;
+                }
+            }
+
+            public:
+            omni_region_tombstones() noexcept = default;
+
+            omni_region_tombstones(const omni_region_tombstones&) = delete;
+            omni_region_tombstones& operator=(const omni_region_tombstones&) = delete;
+
+            void* take_slot() {
+                if (slabs == nullptr or slabs->used == slab_slots) {
+                    slab* fresh = new slab;
+                    fresh->next = slabs;
+                    slabs = fresh;
+                }
+
+                references.fetch_add(1, std::memory_order_relaxed);
+                return slabs->slots[slabs->used++];
+            }
+
+            void release() noexcept {
+                if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+        };
+
+        inline void omni_region_block::delete_allocation() noexcept {
+            table->release();
+        }
+    }
+
+    // Arena of omni_ptr owned objects with a common lifetime.
+    // A region is not thread safe, but pointers it made may be released on any thread,
+    // even while the region ends. Each object is destroyed exactly once.
+    class omni_region {
+        struct chunk {
+            chunk* next;
+            std::size_t size;
+        };
+
+        static constexpr std::size_t header_size = detail::round_up_to_nearest_multiple(sizeof(chunk), alignof(std::max_align_t));
+        static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+        std::size_t chunkSize;
+        chunk* chunks = nullptr;
+        std::byte* cursor = nullptr;
+        std::byte* limit = nullptr;
+        std::size_t reserved = 0;
+
+        detail::omni_region_tombstones* tombstones = nullptr;
+        detail::omni_region_block* blocks = nullptr;
+        std::size_t made = 0;
+
+        std::byte* new_chunk(std::size_t size, std::size_t alignment) {
+            alignment = std::max(alignment, alignof(std::max_align_t));
+
+            std::size_t offset = detail::round_up_to_nearest_multiple(header_size, alignment);
+            std::size_t total = std::max(chunkSize, offset + size);
+
+            void* memory = detail::aligned_alloc(std::align_val_t(alignment), total);
+
+            if (memory == nullptr)
+                throw std::bad_alloc();
+
+            chunks = ::new(memory) chunk{ chunks, total };
+            reserved += total;
+
+            return static_cast<std::byte*>(memory) + offset;
+        }
+
+        void* bump(std::size_t size, std::size_t alignment) {
+            auto address = reinterpret_cast<std::uintptr_t>(cursor);
+            auto aligned = detail::round_up_to_nearest_multiple(address, alignment);
+
+            if (cursor == nullptr or aligned + size > reinterpret_cast<std::uintptr_t>(limit)) {
+                std::byte* start = new_chunk(size, alignment);
+
+                // Oversized objects get a chunk of their own and keep the current one open
+                if (size > chunkSize / 2)
+                    return start;
+
+                cursor = start;
+                limit = reinterpret_cast<std::byte*>(chunks) + chunks->size;
+                aligned = reinterpret_cast<std::uintptr_t>(cursor);
+            }
+
+            cursor = reinterpret_cast<std::byte*>(aligned + size);
+            return reinterpret_cast<void*>(aligned);
+        }
+
+        public:
+        explicit omni_region(std::size_t chunkSize = default_chunk_size)
+        : chunkSize(std::max(chunkSize, header_size + alignof(std::max_align_t))) { }
+
+        omni_region(const omni_region&) = delete;
+        omni_region& operator=(const omni_region&) = delete;
+
+        ~omni_region() {
+            end();
+        }
+
+        template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+        requires (not std::is_array_v<T> and AlignmentPolicy::interface<T, AP> and detail::correct_constructor_args<T, Args...>)
+        omni_ptr<T, AP> make(Args&&... args) {
+            if (tombstones == nullptr)
+                tombstones = new detail::omni_region_tombstones();
+
+            void* storage = bump(AlignmentPolicy::get_stored_size<T, AP>(), static_cast<std::size_t>(AP{}.template get_alignment<T>()));
+
+            // Space left by a failed construction is reclaimed with the rest of the region
+            T* stored = ::new(storage) T(std::forward<Args>(args)...);
+
+            void* slot;
+
+            try {
+                slot = tombstones->take_slot();
+            } catch (...) {
+                stored->~T();
+                throw;
+            }
+
+            constexpr auto destroy = [](void* object) noexcept { static_cast<T*>(object)->~T(); };
+
+            blocks = ::new(slot) detail::omni_region_block(stored, destroy, tombstones, blocks);
+            made++;
+
+            return detail::make_omni_ptr_raw<omni_ptr<T, AP>>(stored, blocks);
+        }
+
+        // Expires and destroys every object still alive, newest first, then frees every chunk.
+        // The region may be used again afterwards.
+        void end() noexcept {
+            for (auto* block = blocks; block != nullptr; block = block->get_next())
+                block->expire();
+
+            while (chunks != nullptr)
+                detail::aligned_free(std::exchange(chunks, chunks->next));
+
+            if (tombstones != nullptr)
+                std::exchange(tombstones, nullptr)->release();
+
+            blocks = nullptr;
+            cursor = nullptr;
+            limit = nullptr;
+            reserved = 0;
+            made = 0;
+        }
+
+        // Objects made since the region began
+        std::size_t object_count() const noexcept {
+            return made;
+        }
+
+        // Bytes held in chunks
+        std::size_t bytes_reserved() const noexcept {
+            return reserved;
+        }
+    };
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <bit>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+// Concurrent id to object registries that own their objects and hand out views.
+// The table is split into shards, each a hash map behind its own reader-writer lock,
+// so lookups of different keys rarely touch the same lock and lookups of the same
+// key only share it. Erasing an entry expires the object on the spot, so every view
+// handed out for it observes the erase immediately.
+//
+// Control blocks of registered objects are unbiased on insertion, since their views
+// are made and dropped by whichever threads look them up. Owners may be inserted from
+// any thread, not only the one that made them.
+
+namespace DxPtr {
+    template<typename K, typename T, typename AP = AlignmentPolicy::Default,
+             typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+    class omni_registry {
+        using owner_t = omni_ptr<T, AP>;
+
+        struct alignas(detail::cache_line_size) shard {
+            mutable std::shared_mutex mutex;
+            std::unordered_map<K, owner_t, Hash, KeyEqual> entries;
+        };
+
+        static constexpr std::size_t default_shard_count = 16;
+
+        std::unique_ptr<shard[]> shards;
+        std::size_t shardBits;
+        Hash hasher;
+
+        // Fibonacci hashing takes the shard from the high bits, which identity hashes leave
+        // well mixed, while the shard's own map keeps using the low bits
+        shard& shard_of(const K& key) const noexcept {
+            auto bits = static_cast<std::uint64_t>(hasher(key));
+
+            if (shardBits == 0)
+                return shards[0];
+
+            return shards[static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> (64 - shardBits))];
+        }
+
+        static void adopt(const owner_t& owner) noexcept {
+            detail::get_control_block(owner)->unbias();
+        }
+
+        public:
+        using key_type = K;
+        using size_type = std::size_t;
+
+        // shardCount is rounded up to a power of two
+        explicit omni_registry(size_type shardCount = default_shard_count)
+        : shards(std::make_unique<shard[]>(std::bit_ceil(std::max<size_type>(shardCount, 1))))
+        , shardBits(static_cast<std::size_t>(std::countr_zero(std::bit_ceil(std::max<size_type>(shardCount, 1))))) { }
+
+        omni_registry(const omni_registry&) = delete;
+        omni_registry& operator=(const omni_registry&) = delete;
+
+        // Constructs the object under key if the key is free.
+        // Returns a ref to the object under key and whether it was made here.
+        template<typename... Args>
+        requires std::constructible_from<T, Args&&...>
+        std::pair<omni_ref<T, AP>, bool> try_emplace(const K& key, Args&&... args) {
+            shard& target = shard_of(key);
+            std::unique_lock lock(target.mutex);
+
+            auto [it, inserted] = target.entries.try_emplace(key);
+
+            if (inserted) {
+                try {
+                    it->second = make_omni<T, AP>(std::forward<Args>(args)...);
+                } catch (...) {
+                    target.entries.erase(it);
+                    throw;
+                }
+
+                adopt(it->second);
+            }
+
+            return { omni_ref<T, AP>(it->second), inserted };
+        }
+
+        // Takes over owner if the key is free, otherwise leaves it untouched
+        std::pair<omni_ref<T, AP>, bool> insert(const K& key, owner_t&& owner) {
+            if (owner == nullptr)
+                throw std::invalid_argument("omni_registry owner is null");
+
+            shard& target = shard_of(key);
+            std::unique_lock lock(target.mutex);
+
+            auto [it, inserted] = target.entries.try_emplace(key);
+
+            if (inserted) {
+                it->second = std::move(owner);
+                adopt(it->second);
+            }
+
+            return { omni_ref<T, AP>(it->second), inserted };
+        }
+
+        // Replacing an entry expires the object it held and destroys it before returning,
+        // with the shard locked as in erase()
+        omni_ref<T, AP> insert_or_assign(const K& key, owner_t&& owner) {
+            if (owner == nullptr)
+                throw std::invalid_argument("omni_registry owner is null");
+
+            shard& target = shard_of(key);
+            std::unique_lock lock(target.mutex);
+
+            owner_t& stored = target.entries[key];
+
+            // Moving an owner swaps, so the old object is taken out and destroyed here
+            // rather than handed back through the caller's owner
+            owner_t old = std::exchange(stored, std::move(owner));
+            adopt(stored);
+            old.reset();
+
+            return omni_ref<T, AP>(stored);
+        }
+
+        // Null if nothing is registered under key
+        omni_ref<T, AP> ref(const K& key) const {
+            shard& target = shard_of(key);
+            std::shared_lock lock(target.mutex);
+
+            auto it = target.entries.find(key);
+            return it == target.entries.end() ? omni_ref<T, AP>() : omni_ref<T, AP>(it->second);
+        }
+
+        omni_view<T, AP> view(const K& key) const {
+            shard& target = shard_of(key);
+            std::shared_lock lock(target.mutex);
+
+            auto it = target.entries.find(key);
+            return it == target.entries.end() ? omni_view<T, AP>() : omni_view<T, AP>(it->second);
+        }
+
+        bool contains(const K& key) const {
+            shard& target = shard_of(key);
+            std::shared_lock lock(target.mutex);
+
+            return target.entries.contains(key);
+        }
+
+        // Calls fn(object) with the shard locked for reading, so the object cannot be erased
+        // while fn runs. Returns false if nothing is registered under key.
+        template<typename Fn>
+        requires std::invocable<Fn&, T&>
+        bool visit(const K& key, Fn&& fn) const {
+            shard& target = shard_of(key);
+            std::shared_lock lock(target.mutex);
+
+            auto it = target.entries.find(key);
+
+            if (it == target.entries.end())
+                return false;
+
+            fn(*it->second);
+            return true;
+        }
+
+        // Expires the object under key and destroys it before returning.
+        // The destructor runs with the shard locked, so it must not call back into the registry.
+        bool erase(const K& key) {
+            shard& target = shard_of(key);
+            std::unique_lock lock(target.mutex);
+
+            return target.entries.erase(key) != 0;
+        }
+
+        // Unregisters the object under key without expiring it
+        owner_t extract(const K& key) {
+            shard& target = shard_of(key);
+            std::unique_lock lock(target.mutex);
+
+            auto node = target.entries.extract(key);
+            return node.empty() ? owner_t() : std::move(node.mapped());
+        }
+
+        // Calls fn(key, object) for every entry, one shard at a time with that shard locked for reading
+        template<typename Fn>
+        requires std::invocable<Fn&, const K&, T&>
+        void for_each(Fn&& fn) const {
+            for (size_type i = 0; i < shard_count(); i++) {
+                std::shared_lock lock(shards[i].mutex);
+
+                for (auto& [key, owner] : shards[i].entries)
+                    fn(key, *owner);
+            }
+        }
+
+        // Expires every object
+        void clear() {
+            for (size_type i = 0; i < shard_count(); i++) {
+                std::unique_lock lock(shards[i].mutex);
+                shards[i].entries.clear();
+            }
+        }
+
+        // Only exact while no other thread is inserting or erasing
+        size_type size() const {
+            size_type total = 0;
+
+            for (size_type i = 0; i < shard_count(); i++) {
+                std::shared_lock lock(shards[i].mutex);
+                total += shards[i].entries.size();
+            }
+
+            return total;
+        }
+
+        bool empty() const {
+            return size() == 0;
+        }
+
+        size_type shard_count() const noexcept {
+            return size_type(1) << shardBits;
+        }
+    };
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+// Relocation moves an object to a new address and ends the lifetime of the source,
+// as one operation. For trivially relocatable types that is a plain memcpy, skipping
+// the move constructor and the destructor of the moved-from object.
+
+namespace DxPtr {
+    // Specialize to true for types that may be relocated with memcpy.
+    // Types holding pointers into themselves (intrusive links, SSO buffers) must not be.
+    template<typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+    template<typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<std::remove_cv_t<T>>::value;
+
+    // omni_ptr, omni_view and omni_ref are a data and a control pointer with no self references.
+    // The tracked pointers are deliberately absent, their list links point at each other.
+    template<typename T, typename AP>
+    struct is_trivially_relocatable<omni_ptr<T, AP>> : std::true_type { };
+
+    template<typename T, typename AP>
+    struct is_trivially_relocatable<omni_view<T, AP>> : std::true_type { };
+
+    template<typename T, typename AP>
+    struct is_trivially_relocatable<omni_ref<T, AP>> : std::true_type { };
+
+    template<typename T, bool O, typename AP>
+    struct is_trivially_relocatable<detail::omni_ptr<T, O, AP>> : std::true_type { };
+
+    // Relocates *source into the uninitialized storage at dest
+    template<typename T>
+    T* omni_relocate(T* source, T* dest) noexcept(is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(source), sizeof(T));
+            return std::launder(dest);
+        } else {
+            T* result = std::construct_at(dest, std::move(*source));
+            std::destroy_at(source);
+            return result;
+        }
+    }
+
+    // Relocates [first, last) into the uninitialized storage at dest.
+    // Ranges may overlap when dest < first, as when erasing from a vector.
+    // If a move constructor throws, the elements not yet relocated are destroyed
+    // and those already relocated live on at dest.
+    template<typename T>
+    T* uninitialized_relocate(T* first, T* last, T* dest) noexcept(is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (first != last)
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+
+            return dest + (last - first);
+        } else {
+            T* current = first;
+
+            try {
+                for (; current != last; ++current, ++dest)
+                    omni_relocate(current, dest);
+            } catch (...) {
+                std::destroy(current, last);
+                throw;
+            }
+
+            return dest;
+        }
+    }
+}
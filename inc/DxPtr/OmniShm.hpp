@@ -0,0 +1,504 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <bit>
+#include <string>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Omni objects in POSIX shared memory, for owners and views living in different processes.
+// A segment maps at a different address in every process, so nothing inside it stores an
+// absolute address. Blocks are found by their offset from the start of the segment, and
+// a block finds its object by an offset from itself.
+//
+// Reference counts cannot survive a crashed process, so blocks carry a stamp instead.
+// The stamp is generation * 2 + 1 while the object lives, and expiring the object bumps
+// it to the next even number in one atomic step. A handle records the stamp it was made
+// with, so a view of it is expired as soon as the two differ, even once the slot has
+// been reused for another object.
+//
+// Objects must not hold pointers into their own process, so T is limited to trivially
+// copyable types. The owner destroys T in its own process.
+//
+// Handles may come from another, possibly misbehaving, process. A view checks that its
+// handle names a slot of the right size inside its mapping before it reads anything, and
+// finds the object by its type rather than by the offset stored in the slot.
+
+namespace DxPtr {
+    template<typename T>
+    class omni_shm_ptr;
+
+    template<typename T>
+    class omni_shm_view;
+
+    // Plain data naming one object in a segment. It may be copied into the segment,
+    // sent over a pipe, or otherwise handed to another process.
+    template<typename T>
+    struct omni_shm_handle {
+        std::uint64_t offset = 0;
+        std::uint32_t stamp = 0;
+
+        explicit operator bool() const noexcept {
+            return offset != 0;
+        }
+
+        bool operator==(const omni_shm_handle&) const = default;
+    };
+
+    namespace detail {
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free and std::atomic<std::uint64_t>::is_always_lock_free,
+            "Shared memory blocks need address-free atomics");
+
+        // Every slot is aligned to a cache line, so no two blocks share one
+        inline constexpr std::size_t shm_slot_alignment = 64;
+
+        struct alignas(shm_slot_alignment) omni_shm_block {
+            std::atomic<std::uint32_t> stamp;
+            std::uint32_t sizeClass;
+
+            // Offset of the stored object from this block
+            std::uint64_t dataOffset;
+
+            // Offset of the next free slot of the same class, while on a freelist
+            std::atomic<std::uint64_t> nextFree;
+
+            bool is_alive(std::uint32_t expected) const noexcept {
+                return stamp.load(std::memory_order_acquire) == expected;
+            }
+
+            void* data() noexcept {
+                return reinterpret_cast<std::byte*>(this) + dataOffset;
+            }
+        };
+
+        struct omni_shm_header {
+            // Freelist heads pack a 40 bit offset with a 24 bit tag against ABA
+            static constexpr std::uint64_t offset_mask = (std::uint64_t(1) << 40) - 1;
+            static constexpr std::uint64_t tag_one = std::uint64_t(1) << 40;
+
+            // One class per power of two from the slot alignment up
+            static constexpr std::size_t size_classes = 40 - std::countr_zero(shm_slot_alignment);
+
+            static constexpr std::uint64_t expected_magic = 0x6f6d6e6973686d31; // "omnishm1"
+
+            std::uint64_t magic;
+            std::uint64_t size;
+            std::atomic<std::uint64_t> cursor;
+            std::atomic<std::uint64_t> freeLists[size_classes];
+        };
+
+        inline constexpr std::size_t shm_data_start = round_up_to_nearest_multiple(sizeof(omni_shm_header), shm_slot_alignment);
+
+        [[noreturn]] inline void throw_shm_error(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+    }
+
+    // A mapping of a named shared memory segment in this process.
+    // Owners and views must not outlive the segment object they were made from.
+    class omni_shm_segment {
+        using header_t = detail::omni_shm_header;
+        using block_t = detail::omni_shm_block;
+
+        std::byte* base = nullptr;
+        std::size_t mappedSize = 0;
+
+        // Only the creating process removes the name again
+        std::string unlinkName;
+
+        omni_shm_segment(std::byte* base, std::size_t mappedSize, std::string unlinkName) noexcept
+        : base(base), mappedSize(mappedSize), unlinkName(std::move(unlinkName)) { }
+
+        header_t& header() const noexcept {
+            return *reinterpret_cast<header_t*>(base);
+        }
+
+        static std::size_t class_size(std::size_t sizeClass) noexcept {
+            return detail::shm_slot_alignment << sizeClass;
+        }
+
+        // Bytes from the slot to the stored T
+        template<typename T>
+        static constexpr std::size_t data_offset() noexcept {
+            return detail::round_up_to_nearest_multiple(sizeof(block_t), alignof(T));
+        }
+
+        template<typename T>
+        static constexpr std::size_t size_class() noexcept {
+            std::size_t total = std::bit_ceil(data_offset<T>() + sizeof(T));
+
+            return static_cast<std::size_t>(std::countr_zero(std::max(total, detail::shm_slot_alignment)))
+                - static_cast<std::size_t>(std::countr_zero(detail::shm_slot_alignment));
+        }
+
+        std::uint64_t pop_free(std::size_t sizeClass) noexcept {
+            auto& head = header().freeLists[sizeClass];
+            std::uint64_t old = head.load(std::memory_order_acquire);
+
+            while ((old & header_t::offset_mask) != 0) {
+                std::uint64_t offset = old & header_t::offset_mask;
+                std::uint64_t next = block_at(offset)->nextFree.load(std::memory_order_relaxed);
+                std::uint64_t replacement = ((old & ~header_t::offset_mask) + header_t::tag_one) | next;
+
+                if (head.compare_exchange_weak(old, replacement, std::memory_order_acquire, std::memory_order_acquire))
+                    return offset;
+            }
+
+            return 0;
+        }
+
+        void push_free(std::uint64_t offset) noexcept {
+            block_t* block = block_at(offset);
+            auto& head = header().freeLists[block->sizeClass];
+            std::uint64_t old = head.load(std::memory_order_relaxed);
+
+            while (true) {
+                block->nextFree.store(old & header_t::offset_mask, std::memory_order_relaxed);
+                std::uint64_t replacement = ((old & ~header_t::offset_mask) + header_t::tag_one) | offset;
+
+                if (head.compare_exchange_weak(old, replacement, std::memory_order_release, std::memory_order_relaxed))
+                    return;
+            }
+        }
+
+        std::uint64_t take_slot(std::size_t sizeClass) {
+            if (std::uint64_t recycled = pop_free(sizeClass))
+                return recycled;
+
+            std::uint64_t bytes = class_size(sizeClass);
+            std::uint64_t offset = header().cursor.load(std::memory_order_relaxed);
+
+            do {
+                if (offset + bytes > header().size)
+                    throw std::bad_alloc();
+            } while (not header().cursor.compare_exchange_weak(offset, offset + bytes, std::memory_order_relaxed));
+
+            // Fresh slots start dead at generation zero
+            block_t* block = ::new(base + offset) block_t{};
+            block->sizeClass = static_cast<std::uint32_t>(sizeClass);
+
+            return offset;
+        }
+
+        block_t* block_at(std::uint64_t offset) const noexcept {
+            return std::launder(reinterpret_cast<block_t*>(base + offset));
+        }
+
+        // Whether a handle from elsewhere names a slot for a T that lies inside this mapping.
+        // A slot keeps its size class for the life of the segment, so checking it once is enough.
+        template<typename T>
+        bool holds(omni_shm_handle<T> id) const noexcept {
+            constexpr std::size_t slot_size = data_offset<T>() + sizeof(T);
+
+            return id.offset >= detail::shm_data_start
+                and id.offset % detail::shm_slot_alignment == 0
+                and slot_size <= mappedSize
+                and id.offset <= mappedSize - slot_size
+                and block_at(id.offset)->sizeClass == size_class<T>();
+        }
+
+        template<typename T>
+        const T* object_at(std::uint64_t offset) const noexcept {
+            return std::launder(reinterpret_cast<const T*>(base + offset + data_offset<T>()));
+        }
+
+        static std::pair<std::byte*, std::size_t> map(int fd, std::size_t size) {
+            void* memory = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            int error = errno;
+
+            ::close(fd);
+
+            if (memory == MAP_FAILED) {
+                errno = error;
+                detail::throw_shm_error("mmap");
+            }
+
+            return { static_cast<std::byte*>(memory), size };
+        }
+
+        public:
+        omni_shm_segment(const omni_shm_segment&) = delete;
+        omni_shm_segment& operator=(const omni_shm_segment&) = delete;
+
+        omni_shm_segment(omni_shm_segment&& move) noexcept
+        : base(std::exchange(move.base, nullptr))
+        , mappedSize(std::exchange(move.mappedSize, 0))
+        , unlinkName(std::move(move.unlinkName)) {
+            move.unlinkName.clear();
+        }
+
+        omni_shm_segment& operator=(omni_shm_segment&& move) noexcept {
+            std::swap(base, move.base);
+            std::swap(mappedSize, move.mappedSize);
+            std::swap(unlinkName, move.unlinkName);
+
+            return *this;
+        }
+
+        ~omni_shm_segment() {
+            if (base != nullptr)
+                ::munmap(base, mappedSize);
+
+            if (not unlinkName.empty())
+                ::shm_unlink(unlinkName.c_str());
+        }
+
+        // Creates a new segment of size bytes, failing if the name is taken.
+        // The name is removed again when this object is destroyed.
+        static omni_shm_segment create(const std::string& name, std::size_t size) {
+            size = std::max(size, detail::shm_data_start + detail::shm_slot_alignment);
+
+            int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+            if (fd == -1)
+                detail::throw_shm_error("shm_open");
+
+            if (::ftruncate(fd, static_cast<off_t>(size)) == -1) {
+                int error = errno;
+
+                ::close(fd);
+                ::shm_unlink(name.c_str());
+
+                errno = error;
+                detail::throw_shm_error("ftruncate");
+            }
+
+            std::byte* memory;
+
+            try {
+                memory = map(fd, size).first;
+            } catch (...) {
+                ::shm_unlink(name.c_str());
+                throw;
+            }
+
+            auto* header = ::new(memory) header_t{};
+            header->size = size;
+            header->cursor.store(detail::shm_data_start, std::memory_order_relaxed);
+
+            // Published last, so open() never sees a half initialized header
+            std::atomic_ref(header->magic).store(header_t::expected_magic, std::memory_order_release);
+
+            return omni_shm_segment(memory, size, name);
+        }
+
+        // Maps an existing segment made by create()
+        static omni_shm_segment open(const std::string& name) {
+            int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+
+            if (fd == -1)
+                detail::throw_shm_error("shm_open");
+
+            struct stat info;
+
+            if (::fstat(fd, &info) == -1) {
+                int error = errno;
+                ::close(fd);
+
+                errno = error;
+                detail::throw_shm_error("fstat");
+            }
+
+            auto [memory, size] = map(fd, static_cast<std::size_t>(info.st_size));
+            omni_shm_segment segment(memory, size, {});
+
+            if (size < sizeof(header_t) or std::atomic_ref(segment.header().magic).load(std::memory_order_acquire) != header_t::expected_magic)
+                throw std::system_error(std::make_error_code(std::errc::invalid_argument), "Not an omni_shm_segment");
+
+            return segment;
+        }
+
+        template<typename T, typename... Args>
+        requires (std::is_trivially_copyable_v<T> and alignof(T) <= detail::shm_slot_alignment
+            and not std::is_array_v<T> and detail::correct_constructor_args<T, Args...>)
+        omni_shm_ptr<T> make(Args&&... args) {
+            constexpr std::size_t sizeClass = size_class<T>();
+            static_assert(sizeClass < header_t::size_classes, "Object too large for a shared memory slot");
+
+            std::uint64_t offset = take_slot(sizeClass);
+            block_t* block = block_at(offset);
+
+            block->dataOffset = data_offset<T>();
+
+            try {
+                ::new(block->data()) T(std::forward<Args>(args)...);
+            } catch (...) {
+                push_free(offset);
+                throw;
+            }
+
+            // Dead slots hold an even stamp, so this makes it live under the next odd one
+            std::uint32_t stamp = block->stamp.load(std::memory_order_relaxed) + 1;
+            block->stamp.store(stamp, std::memory_order_release);
+
+            return omni_shm_ptr<T>(this, omni_shm_handle<T>{ offset, stamp });
+        }
+
+        // Bytes handed out so far, including slots that are now free again
+        std::size_t bytes_used() const noexcept {
+            return header().cursor.load(std::memory_order_relaxed);
+        }
+
+        std::size_t size() const noexcept {
+            return mappedSize;
+        }
+
+        template<typename T>
+        friend class omni_shm_ptr;
+
+        template<typename T>
+        friend class omni_shm_view;
+    };
+
+    // Owner of an object in a shared memory segment. Resetting it expires every view
+    // in every process, destroys T here, and returns the slot to the segment.
+    template<typename T>
+    class omni_shm_ptr {
+        omni_shm_segment* segment = nullptr;
+        omni_shm_handle<T> id;
+
+        omni_shm_ptr(omni_shm_segment* segment, omni_shm_handle<T> id) noexcept
+        : segment(segment), id(id) { }
+
+        detail::omni_shm_block* block() const noexcept {
+            return segment->block_at(id.offset);
+        }
+
+        public:
+        using element_type = T;
+        using pointer = T*;
+
+        constexpr omni_shm_ptr() noexcept = default;
+        constexpr omni_shm_ptr(std::nullptr_t) noexcept { }
+
+        omni_shm_ptr(const omni_shm_ptr&) = delete;
+        omni_shm_ptr& operator=(const omni_shm_ptr&) = delete;
+
+        omni_shm_ptr(omni_shm_ptr&& move) noexcept
+        : segment(std::exchange(move.segment, nullptr)), id(std::exchange(move.id, {})) { }
+
+        omni_shm_ptr& operator=(omni_shm_ptr&& move) noexcept {
+            omni_shm_ptr(std::move(move)).swap(*this);
+            return *this;
+        }
+
+        ~omni_shm_ptr() {
+            reset();
+        }
+
+        void reset() noexcept {
+            if (segment == nullptr)
+                return;
+
+            detail::omni_shm_block* stored = block();
+
+            // Views compare stamps before touching T, so expire first
+            stored->stamp.fetch_add(1, std::memory_order_acq_rel);
+            std::launder(static_cast<T*>(stored->data()))->~T();
+
+            segment->push_free(id.offset);
+
+            segment = nullptr;
+            id = {};
+        }
+
+        void swap(omni_shm_ptr& other) noexcept {
+            std::swap(segment, other.segment);
+            std::swap(id, other.id);
+        }
+
+        // What another process needs to make a view of this object
+        omni_shm_handle<T> handle() const noexcept {
+            return id;
+        }
+
+        pointer get() const noexcept {
+            return segment == nullptr ? nullptr : std::launder(static_cast<T*>(block()->data()));
+        }
+
+        T& operator*() const noexcept {
+            return *get();
+        }
+
+        pointer operator->() const noexcept {
+            return get();
+        }
+
+        explicit operator bool() const noexcept {
+            return segment != nullptr;
+        }
+
+        friend class omni_shm_segment;
+
+        template<typename T2>
+        friend class omni_shm_view;
+    };
+
+    // Process-local view of an object in a segment, made from a handle and this process's
+    // mapping of the segment. Like omni_view, it may dangle only between checking expired()
+    // and dereferencing if the owner is reset concurrently.
+    template<typename T>
+    class omni_shm_view {
+        const omni_shm_segment* segment = nullptr;
+        omni_shm_handle<T> id;
+
+        const detail::omni_shm_block* block() const noexcept {
+            return segment->block_at(id.offset);
+        }
+
+        public:
+        using element_type = const T;
+        using pointer = const T*;
+
+        constexpr omni_shm_view() noexcept = default;
+        constexpr omni_shm_view(std::nullptr_t) noexcept { }
+
+        // Throws std::system_error with std::errc::invalid_argument if the handle
+        // does not name a slot for a T inside the segment
+        omni_shm_view(const omni_shm_segment& segment, omni_shm_handle<T> id)
+        : segment(id ? &segment : nullptr), id(id) {
+            if (id and not segment.holds(id))
+                throw std::system_error(std::make_error_code(std::errc::invalid_argument), "Handle outside the omni_shm_segment");
+        }
+
+        omni_shm_view(const omni_shm_ptr<T>& owner) noexcept
+        : segment(owner.segment), id(owner.id) { }
+
+        void reset() noexcept {
+            segment = nullptr;
+            id = {};
+        }
+
+        omni_shm_handle<T> handle() const noexcept {
+            return id;
+        }
+
+        bool expired() const noexcept {
+            return segment == nullptr or not block()->is_alive(id.stamp);
+        }
+
+        explicit operator bool() const noexcept {
+            return not expired();
+        }
+
+        // Null once expired
+        pointer get() const noexcept {
+            if (expired())
+                return nullptr;
+
+            return segment->template object_at<T>(id.offset);
+        }
+
+        const T& operator*() const noexcept {
+            return *segment->template object_at<T>(id.offset);
+        }
+
+        pointer operator->() const noexcept {
+            return segment->template object_at<T>(id.offset);
+        }
+    };
+}
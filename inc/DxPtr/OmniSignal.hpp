@@ -0,0 +1,231 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <functional>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Signals whose slots call into receivers held by omni_view or omni_ref. A slot keeps only a
+// weak hold on its receiver's control block, so a receiver that is destroyed never has to
+// disconnect: emission skips its slots and compacts them away as it walks the slot list.
+//
+// Slots live in one contiguous vector and the receivers of upcoming slots are prefetched,
+// so fanning out to many subscribers streams through memory.
+// Like the standard containers, a signal is not thread safe.
+
+namespace DxPtr {
+    namespace detail {
+        inline void prefetch([[maybe_unused]] const void* address) noexcept {
+            #if defined(__GNUC__) or defined(__clang__)
+            __builtin_prefetch(address);
+            #endif
+        }
+    }
+
+    template<typename... Args>
+    class omni_signal {
+        using target_t = void (*)();
+        using thunk_t = void (*)(target_t, void*, Args&...);
+
+        // Trivially copyable so compaction is a plain move of 32 bytes.
+        // A non-null control is a counted hold on the receiver's block.
+        struct slot {
+            detail::omni_block_base* control;
+            void* receiver;
+            thunk_t thunk;
+            target_t target;
+
+            bool live() const noexcept {
+                return control != nullptr and not control->is_expired();
+            }
+
+            void release() noexcept {
+                if (control != nullptr)
+                    std::exchange(control, nullptr)->decrement();
+            }
+        };
+
+        // How many slots ahead receivers are prefetched
+        static constexpr std::size_t prefetch_distance = 4;
+
+        std::vector<slot> slots;
+        unsigned emitting = 0;
+
+        template<typename C, bool O, typename AP>
+        void add_slot(const detail::omni_ptr<C, O, AP>& receiver, thunk_t thunk, target_t target) {
+            if (receiver == nullptr)
+                throw std::invalid_argument("omni_signal receiver is null or expired");
+
+            auto* control = detail::get_control_block(receiver);
+            slots.push_back({ control, const_cast<std::remove_const_t<C>*>(receiver.get()), thunk, target });
+            control->increment();
+        }
+
+        // Drops released slots from [first, last)
+        void close_gap(std::size_t first, std::size_t last) noexcept {
+            slots.erase(slots.begin() + first, slots.begin() + last);
+        }
+
+        public:
+        omni_signal() = default;
+
+        omni_signal(omni_signal&& move) noexcept : slots(std::move(move.slots)) { }
+
+        omni_signal& operator=(omni_signal&& move) noexcept {
+            clear();
+            slots = std::move(move.slots);
+
+            return *this;
+        }
+
+        ~omni_signal() {
+            for (auto& entry : slots)
+                entry.release();
+        }
+
+        // Calls (receiver->*Method)(args...) on each emission while the receiver lives.
+        // Receivers held by omni_view need a const Method.
+        template<auto Method, typename C, bool O, typename AP>
+        requires std::is_member_function_pointer_v<decltype(Method)> and std::invocable<decltype(Method), C&, Args&...>
+        void connect(const detail::omni_ptr<C, O, AP>& receiver) {
+            thunk_t thunk = [](target_t, void* object, Args&... args) {
+                std::invoke(Method, *static_cast<C*>(object), args...);
+            };
+
+            add_slot(receiver, thunk, nullptr);
+        }
+
+        // Calls fn(*receiver, args...) on each emission while the receiver lives
+        template<typename C, bool O, typename AP>
+        void connect(const detail::omni_ptr<C, O, AP>& receiver, std::type_identity_t<void (*)(C&, Args&...)> fn) {
+            if (fn == nullptr)
+                throw std::invalid_argument("omni_signal slot function is null");
+
+            thunk_t thunk = [](target_t target, void* object, Args&... args) {
+                reinterpret_cast<void (*)(C&, Args&...)>(target)(*static_cast<C*>(object), args...);
+            };
+
+            add_slot(receiver, thunk, reinterpret_cast<target_t>(fn));
+        }
+
+        // Removes every slot of receiver's owner, returning how many were connected.
+        // Safe to call from inside a slot.
+        template<typename C, bool O, typename AP>
+        std::size_t disconnect(const detail::omni_ptr<C, O, AP>& receiver) noexcept {
+            auto* control = detail::get_control_block(receiver);
+
+            if (control == nullptr)
+                return 0;
+
+            std::size_t removed = 0;
+
+            for (auto& entry : slots) {
+                if (entry.control == control) {
+                    entry.release();
+                    removed++;
+                }
+            }
+
+            compact();
+
+            return removed;
+        }
+
+        // Calls every slot whose receiver is alive, in connection order. Slots connected
+        // during emission are first called by the next one. Expired and disconnected slots
+        // are compacted away unless this is a nested emission from inside a slot.
+        void emit(Args... args) {
+            bool compacting = emitting == 0;
+            std::size_t end = slots.size();
+            std::size_t kept = 0;
+            std::size_t next = 0;
+
+            emitting++;
+
+            try {
+                for (; next < end; next++) {
+                    if (next + prefetch_distance < end) {
+                        const slot& ahead = slots[next + prefetch_distance];
+                        detail::prefetch(ahead.control);
+                        detail::prefetch(ahead.receiver);
+                    }
+
+                    slot& entry = slots[next];
+
+                    if (not entry.live()) {
+                        entry.release();
+                        continue;
+                    }
+
+                    // The slot may connect more and reallocate, so it is called through a copy
+                    slot current = entry;
+
+                    if (compacting and kept != next) {
+                        slots[kept] = entry;
+                        entry.control = nullptr;
+                    }
+
+                    kept++;
+                    current.thunk(current.target, current.receiver, args...);
+                }
+            } catch (...) {
+                emitting--;
+
+                if (compacting)
+                    close_gap(kept, next + 1);
+
+                throw;
+            }
+
+            emitting--;
+
+            if (compacting)
+                close_gap(kept, end);
+        }
+
+        void operator()(Args... args) {
+            emit(args...);
+        }
+
+        // Drops expired and disconnected slots now rather than at the next emission.
+        // Returns how many were dropped. Does nothing while emitting.
+        std::size_t compact() noexcept {
+            if (emitting != 0)
+                return 0;
+
+            std::size_t kept = 0;
+
+            for (std::size_t i = 0; i < slots.size(); i++) {
+                if (not slots[i].live()) {
+                    slots[i].release();
+                    continue;
+                }
+
+                slots[kept++] = std::exchange(slots[i], slot{});
+            }
+
+            std::size_t dropped = slots.size() - kept;
+            slots.resize(kept);
+
+            return dropped;
+        }
+
+        // Disconnects every slot
+        void clear() noexcept {
+            for (auto& entry : slots)
+                entry.release();
+
+            compact();
+        }
+
+        // Includes slots whose receiver expired but which were not compacted yet
+        std::size_t size() const noexcept {
+            return slots.size();
+        }
+
+        bool empty() const noexcept {
+            return slots.empty();
+        }
+    };
+}
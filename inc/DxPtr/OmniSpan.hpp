@@ -0,0 +1,463 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <array>
+#include <span>
+#include <stdexcept>
+
+// Lifetime-checked slices of omni arrays. omni_span<T> references a contiguous sub-range and
+// omni_mdspan<T, Extents, Layout> a multidimensional view of one. Both hold a counted
+// reference to the array's control block like omni_view does, so they expire with the owner
+// and may be passed between stages that outlive it.
+//
+// Element access and iteration do not check expiry. Check expired() first, or take span()
+// once, which checks and hands back a plain std::span for tight loops.
+//
+// C++20 has no std::mdspan, so omni_extents and the layouts below cover the subset needed:
+// static and dynamic extents, row and column major layouts, and strided tiles.
+
+namespace DxPtr {
+    template<typename T>
+    class omni_span;
+
+    namespace detail {
+        // Shared by omni_span and omni_mdspan
+        class omni_slice_base {
+            protected:
+            omni_block_base* control = nullptr;
+
+            constexpr omni_slice_base() noexcept = default;
+
+            explicit omni_slice_base(omni_block_base* control) : control(control) {
+                if (control != nullptr)
+                    control->increment();
+            }
+
+            omni_slice_base(const omni_slice_base& copy) : omni_slice_base(copy.control) { }
+
+            omni_slice_base(omni_slice_base&& move) noexcept
+            : control(std::exchange(move.control, nullptr)) { }
+
+            ~omni_slice_base() {
+                if (control != nullptr)
+                    control->decrement();
+            }
+
+            void release() noexcept {
+                if (control != nullptr)
+                    std::exchange(control, nullptr)->decrement();
+            }
+
+            public:
+            bool expired() const noexcept {
+                return control == nullptr or control->is_expired();
+            }
+
+            explicit operator bool() const noexcept {
+                return not expired();
+            }
+
+            long use_count() const noexcept {
+                return control == nullptr ? 0 : static_cast<long>(control->use_count());
+            }
+        };
+
+        // Whole array of an owner, checking count against the size when the block knows it
+        template<typename U, typename AP>
+        std::size_t owner_extent(const DxPtr::omni_ptr<U[], AP>& owner, std::size_t count) {
+            const auto* control = detail::get_control_block(owner);
+
+            if (control != nullptr and control->knows_extent() and count > control->array_extent())
+                throw std::out_of_range("omni_span past the end of the array");
+
+            return count;
+        }
+    }
+
+    template<typename T>
+    class omni_span : public detail::omni_slice_base {
+        T* first = nullptr;
+        std::size_t count = 0;
+
+        omni_span(T* first, std::size_t count, detail::omni_block_base* control)
+        : omni_slice_base(control), first(first), count(count) { }
+
+        public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using size_type = std::size_t;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        constexpr omni_span() noexcept = default;
+        constexpr omni_span(std::nullptr_t) noexcept { }
+
+        // The whole array, which must have been made with make_omni
+        template<typename U, typename AP>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        omni_span(const omni_ptr<U[], AP>& owner)
+        : omni_span(owner.get(), owner.size(), detail::get_control_block(owner)) {
+            if (owner != nullptr and not detail::get_control_block(owner)->knows_extent())
+                throw std::invalid_argument("omni_span of an array of unknown size needs a count");
+        }
+
+        // The first count elements. Needed for arrays adopted from a raw pointer.
+        template<typename U, typename AP>
+        requires std::convertible_to<U(*)[], T(*)[]>
+        omni_span(const omni_ptr<U[], AP>& owner, std::size_t count)
+        : omni_span(owner.get(), detail::owner_extent(owner, count), detail::get_control_block(owner)) { }
+
+        omni_span(const omni_span&) = default;
+        omni_span(omni_span&&) noexcept = default;
+
+        // From omni_span<T> to omni_span<const T>
+        template<typename U>
+        requires (not std::is_same_v<U, T> and std::convertible_to<U(*)[], T(*)[]>)
+        omni_span(const omni_span<U>& copy) : omni_span(copy.first, copy.count, copy.control) { }
+
+        omni_span& operator=(omni_span copy) noexcept {
+            swap(copy);
+            return *this;
+        }
+
+        void swap(omni_span& other) noexcept {
+            std::swap(control, other.control);
+            std::swap(first, other.first);
+            std::swap(count, other.count);
+        }
+
+        void reset() noexcept {
+            release();
+            first = nullptr;
+            count = 0;
+        }
+
+        size_type size() const noexcept { return count; }
+        size_type size_bytes() const noexcept { return count * sizeof(T); }
+        bool empty() const noexcept { return count == 0; }
+
+        // Null once expired
+        pointer data() const noexcept {
+            return expired() ? nullptr : first;
+        }
+
+        // Checks expiry once. Empty if the array is gone.
+        std::span<T> span() const noexcept {
+            return expired() ? std::span<T>() : std::span<T>(first, count);
+        }
+
+        iterator begin() const noexcept { return first; }
+        iterator end() const noexcept { return first + count; }
+
+        reference operator[](size_type index) const noexcept {
+            return first[index];
+        }
+
+        reference front() const noexcept { return first[0]; }
+        reference back() const noexcept { return first[count - 1]; }
+
+        omni_span subspan(size_type offset, size_type length = std::dynamic_extent) const {
+            if (offset > count)
+                throw std::out_of_range("omni_span::subspan offset past the end");
+
+            if (length == std::dynamic_extent)
+                length = count - offset;
+            else if (length > count - offset)
+                throw std::out_of_range("omni_span::subspan length past the end");
+
+            return omni_span(first + offset, length, control);
+        }
+
+        omni_span first_n(size_type length) const { return subspan(0, length); }
+        omni_span last_n(size_type length) const { return subspan(count - std::min(length, count), length); }
+
+        template<typename U>
+        friend class omni_span;
+
+        template<typename T2, typename Extents, typename Layout>
+        friend class omni_mdspan;
+    };
+
+    template<typename U, typename AP>
+    omni_span(const omni_ptr<U[], AP>&) -> omni_span<U>;
+
+    template<typename U, typename AP>
+    omni_span(const omni_ptr<U[], AP>&, std::size_t) -> omni_span<U>;
+
+    template<std::size_t... Exts>
+    class omni_extents {
+        static constexpr std::size_t rank_count = sizeof...(Exts);
+        static constexpr std::size_t dynamic_count = ((Exts == std::dynamic_extent ? 1 : 0) + ... + 0);
+        static constexpr std::array<std::size_t, rank_count> static_extents = { Exts... };
+
+        std::array<std::size_t, dynamic_count> dynamicExtents{};
+
+        // Slot of dimension r among the dynamic ones
+        static constexpr std::size_t dynamic_index(std::size_t r) noexcept {
+            std::size_t index = 0;
+
+            for (std::size_t i = 0; i < r; i++)
+                index += static_extents[i] == std::dynamic_extent;
+
+            return index;
+        }
+
+        public:
+        using index_type = std::size_t;
+
+        constexpr omni_extents() noexcept = default;
+
+        // Either every dynamic extent, or every extent with the static ones matching
+        template<std::convertible_to<std::size_t>... Sizes>
+        requires (sizeof...(Sizes) != 0 and (sizeof...(Sizes) == dynamic_count or sizeof...(Sizes) == rank_count))
+        constexpr explicit omni_extents(Sizes... sizes) {
+            std::array<std::size_t, sizeof...(Sizes)> given = { static_cast<std::size_t>(sizes)... };
+
+            if constexpr (sizeof...(Sizes) == dynamic_count) {
+                dynamicExtents = given;
+            } else {
+                for (std::size_t r = 0; r < rank_count; r++) {
+                    if (static_extents[r] == std::dynamic_extent)
+                        dynamicExtents[dynamic_index(r)] = given[r];
+                    else if (static_extents[r] != given[r])
+                        throw std::invalid_argument("omni_extents does not match a static extent");
+                }
+            }
+        }
+
+        static constexpr std::size_t rank() noexcept { return rank_count; }
+        static constexpr std::size_t rank_dynamic() noexcept { return dynamic_count; }
+
+        static constexpr std::size_t static_extent(std::size_t r) noexcept {
+            return static_extents[r];
+        }
+
+        constexpr std::size_t extent(std::size_t r) const noexcept {
+            return static_extents[r] == std::dynamic_extent ? dynamicExtents[dynamic_index(r)] : static_extents[r];
+        }
+
+        // Number of elements
+        constexpr std::size_t size() const noexcept {
+            std::size_t product = 1;
+
+            for (std::size_t r = 0; r < rank_count; r++)
+                product *= extent(r);
+
+            return product;
+        }
+
+        constexpr bool operator==(const omni_extents&) const noexcept = default;
+    };
+
+    namespace detail {
+        template<std::size_t Rank, typename Seq = std::make_index_sequence<Rank>>
+        struct dynamic_extents;
+
+        template<std::size_t Rank, std::size_t... I>
+        struct dynamic_extents<Rank, std::index_sequence<I...>> {
+            using type = omni_extents<((void) I, std::dynamic_extent)...>;
+        };
+
+        // Every layout maps indices through one stride per dimension
+        template<typename Extents>
+        class strided_mapping {
+            static constexpr std::size_t rank = Extents::rank();
+
+            Extents shape;
+            std::array<std::size_t, rank> strides{};
+
+            public:
+            using extents_type = Extents;
+
+            constexpr strided_mapping() noexcept = default;
+
+            constexpr strided_mapping(const Extents& shape, const std::array<std::size_t, rank>& strides) noexcept
+            : shape(shape), strides(strides) { }
+
+            constexpr const Extents& extents() const noexcept { return shape; }
+            constexpr std::size_t stride(std::size_t r) const noexcept { return strides[r]; }
+            constexpr const std::array<std::size_t, rank>& get_strides() const noexcept { return strides; }
+
+            template<typename... Indices>
+            constexpr std::size_t operator()(Indices... indices) const noexcept {
+                std::array<std::size_t, rank> at = { static_cast<std::size_t>(indices)... };
+                std::size_t offset = 0;
+
+                for (std::size_t r = 0; r < rank; r++)
+                    offset += at[r] * strides[r];
+
+                return offset;
+            }
+
+            // One past the furthest element reachable, or 0 when any extent is 0
+            constexpr std::size_t required_span_size() const noexcept {
+                std::size_t furthest = 0;
+
+                for (std::size_t r = 0; r < rank; r++) {
+                    if (shape.extent(r) == 0)
+                        return 0;
+
+                    furthest += (shape.extent(r) - 1) * strides[r];
+                }
+
+                return furthest + 1;
+            }
+
+            // Every element in [0, required_span_size()) is reachable exactly once
+            constexpr bool is_exhaustive() const noexcept {
+                return required_span_size() == shape.size();
+            }
+        };
+    }
+
+    template<std::size_t Rank>
+    using omni_dextents = typename detail::dynamic_extents<Rank>::type;
+
+    // Row major, the last index is contiguous
+    struct layout_right {
+        template<typename Extents>
+        static constexpr std::array<std::size_t, Extents::rank()> strides_for(const Extents& shape) noexcept {
+            std::array<std::size_t, Extents::rank()> strides{};
+            std::size_t stride = 1;
+
+            for (std::size_t r = Extents::rank(); r > 0; r--) {
+                strides[r - 1] = stride;
+                stride *= shape.extent(r - 1);
+            }
+
+            return strides;
+        }
+    };
+
+    // Column major, the first index is contiguous
+    struct layout_left {
+        template<typename Extents>
+        static constexpr std::array<std::size_t, Extents::rank()> strides_for(const Extents& shape) noexcept {
+            std::array<std::size_t, Extents::rank()> strides{};
+            std::size_t stride = 1;
+
+            for (std::size_t r = 0; r < Extents::rank(); r++) {
+                strides[r] = stride;
+                stride *= shape.extent(r);
+            }
+
+            return strides;
+        }
+    };
+
+    // Arbitrary strides, as used by tiles of the other two
+    struct layout_stride { };
+
+    template<typename T, typename Extents, typename Layout = layout_right>
+    class omni_mdspan : public detail::omni_slice_base {
+        static constexpr std::size_t rank = Extents::rank();
+
+        using mapping_type = detail::strided_mapping<Extents>;
+
+        T* origin = nullptr;
+        mapping_type map;
+
+        omni_mdspan(T* origin, const mapping_type& map, detail::omni_block_base* control)
+        : omni_slice_base(control), origin(origin), map(map) { }
+
+        static mapping_type checked_mapping(const mapping_type& map, std::size_t available) {
+            if (map.required_span_size() > available)
+                throw std::out_of_range("omni_mdspan larger than its span");
+
+            return map;
+        }
+
+        public:
+        using element_type = T;
+        using value_type = std::remove_cv_t<T>;
+        using extents_type = Extents;
+        using layout_type = Layout;
+        using reference = T&;
+
+        constexpr omni_mdspan() noexcept = default;
+        constexpr omni_mdspan(std::nullptr_t) noexcept { }
+
+        // Lays shape out over a span with the layout's own strides
+        template<typename U>
+        requires (not std::is_same_v<Layout, layout_stride> and std::convertible_to<U(*)[], T(*)[]>)
+        omni_mdspan(const omni_span<U>& span, const Extents& shape)
+        : omni_mdspan(span.first, checked_mapping(mapping_type(shape, Layout::strides_for(shape)), span.size()), span.control) { }
+
+        template<typename U>
+        requires (std::is_same_v<Layout, layout_stride> and std::convertible_to<U(*)[], T(*)[]>)
+        omni_mdspan(const omni_span<U>& span, const Extents& shape, const std::array<std::size_t, rank>& strides)
+        : omni_mdspan(span.first, checked_mapping(mapping_type(shape, strides), span.size()), span.control) { }
+
+        omni_mdspan(const omni_mdspan&) = default;
+        omni_mdspan(omni_mdspan&&) noexcept = default;
+
+        // From omni_mdspan<T> to omni_mdspan<const T>
+        template<typename U>
+        requires (not std::is_same_v<U, T> and std::convertible_to<U(*)[], T(*)[]>)
+        omni_mdspan(const omni_mdspan<U, Extents, Layout>& copy) : omni_mdspan(copy.origin, copy.map, copy.control) { }
+
+        omni_mdspan& operator=(omni_mdspan copy) noexcept {
+            swap(copy);
+            return *this;
+        }
+
+        void swap(omni_mdspan& other) noexcept {
+            std::swap(control, other.control);
+            std::swap(origin, other.origin);
+            std::swap(map, other.map);
+        }
+
+        void reset() noexcept {
+            release();
+            origin = nullptr;
+            map = {};
+        }
+
+        template<typename... Indices>
+        requires (sizeof...(Indices) == rank and (std::convertible_to<Indices, std::size_t> and ...))
+        reference operator()(Indices... indices) const noexcept {
+            return origin[map(indices...)];
+        }
+
+        const Extents& extents() const noexcept { return map.extents(); }
+        std::size_t extent(std::size_t r) const noexcept { return map.extents().extent(r); }
+        std::size_t stride(std::size_t r) const noexcept { return map.stride(r); }
+        std::size_t size() const noexcept { return map.extents().size(); }
+        bool empty() const noexcept { return size() == 0; }
+        bool is_exhaustive() const noexcept { return map.is_exhaustive(); }
+
+        // Null once expired
+        T* data_handle() const noexcept {
+            return expired() ? nullptr : origin;
+        }
+
+        // The elements as one contiguous span, only for exhaustive layouts
+        omni_span<T> flat() const {
+            if (not is_exhaustive())
+                throw std::logic_error("omni_mdspan::flat of a non-contiguous layout");
+
+            return omni_span<T>(origin, size(), control);
+        }
+
+        // The block of sizes[r] elements starting at offsets[r] in every dimension
+        omni_mdspan<T, omni_dextents<rank>, layout_stride> tile(const std::array<std::size_t, rank>& offsets, const std::array<std::size_t, rank>& sizes) const {
+            using tile_t = omni_mdspan<T, omni_dextents<rank>, layout_stride>;
+            using tile_extents = omni_dextents<rank>;
+
+            tile_extents shape = std::apply([](auto... s) { return tile_extents(s...); }, sizes);
+
+            for (std::size_t r = 0; r < rank; r++) {
+                if (offsets[r] > extent(r) or sizes[r] > extent(r) - offsets[r])
+                    throw std::out_of_range("omni_mdspan::tile past the end");
+            }
+
+            T* corner = std::apply([this](auto... o) { return origin + map(o...); }, offsets);
+
+            return tile_t(corner, typename tile_t::mapping_type(shape, map.get_strides()), control);
+        }
+
+        template<typename T2, typename Extents2, typename Layout2>
+        friend class omni_mdspan;
+    };
+}
@@ -0,0 +1,448 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Spillable owners page cold objects out to a local file. spill() writes T to the
+// spill file, destroys it and hands its pages back to the OS, and the next dereference
+// through the owner or any view reads it back in. The address of T never changes, so
+// views made before a spill stay valid, and expiry and use_count() behave as usual.
+//
+// Rehydration reuses the pending construction of lazily made objects, so T must opt
+// in through lazy_construction<T> for views to check for it on dereference.
+// Trivially copyable types are spilled as raw bytes. Other types provide
+// void spill(std::ostream&) const and static T unspill(std::istream&).
+//
+// spill() must not race with accesses to the object, just like reset().
+// Rehydration itself is safe from any number of threads at once.
+
+namespace DxPtr {
+    template<typename T>
+    concept omni_spill_serializable = std::is_trivially_copyable_v<T> or requires(const T& object, std::ostream& out, std::istream& in) {
+        object.spill(out);
+        { T::unspill(in) } -> std::same_as<T>;
+    };
+
+    template<typename T, typename AP>
+    class omni_spillable;
+
+    class omni_spill_file;
+
+    template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+    requires (not std::is_array_v<T> and omni_spill_serializable<T> and std::constructible_from<T, Args&&...>)
+    omni_spillable<T, AP> make_omni_spillable(omni_spill_file& file, Args&&... args);
+
+    namespace detail {
+        struct spill_extent {
+            std::uint64_t offset = 0;
+            std::size_t capacity = 0;
+        };
+
+        // One unlinked temporary file shared by a spill file handle and every object spilled to it.
+        // Each object keeps the extent it last spilled to and reuses it while its bytes fit.
+        class omni_spill_state {
+            int fd;
+
+            std::mutex extentMutex;
+            std::uint64_t end = 0;
+            std::vector<spill_extent> freeExtents;
+
+            std::atomic<std::uint64_t> spills = 0;
+            std::atomic<std::uint64_t> loads = 0;
+            std::atomic<std::uint64_t> spilledBytes = 0;
+            std::atomic<std::size_t> references = 1;
+
+            ~omni_spill_state() {
+                ::close(fd);
+            }
+
+            public:
+            explicit omni_spill_state(const std::filesystem::path& directory) {
+                std::string pattern = (directory / "omni_spill_XXXXXX").string();
+
+                fd = ::mkstemp(pattern.data());
+
+                if (fd == -1)
+                    throw std::system_error(errno, std::generic_category(), "mkstemp");
+
+                // The file goes away with its last descriptor
+                ::unlink(pattern.c_str());
+            }
+
+            omni_spill_state(const omni_spill_state&) = delete;
+            omni_spill_state& operator=(const omni_spill_state&) = delete;
+
+            void acquire() noexcept {
+                references.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void release() noexcept {
+                if (references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete this;
+            }
+
+            // First fit from freed extents, otherwise the end of the file
+            spill_extent reserve(std::size_t size) {
+                std::scoped_lock lock(extentMutex);
+
+                for (auto it = freeExtents.begin(); it != freeExtents.end(); ++it) {
+                    if (it->capacity >= size) {
+                        spill_extent found = *it;
+                        freeExtents.erase(it);
+                        return found;
+                    }
+                }
+
+                spill_extent fresh{ end, size };
+                end += size;
+
+                return fresh;
+            }
+
+            void free(spill_extent extent) noexcept {
+                if (extent.capacity == 0)
+                    return;
+
+                std::scoped_lock lock(extentMutex);
+
+                try {
+                    freeExtents.push_back(extent);
+                } catch (...) {
+                    // Losing track of an extent only leaves a hole in the file
+                }
+            }
+
+            void write(spill_extent extent, const void* source, std::size_t size) {
+                auto* bytes = static_cast<const std::byte*>(source);
+
+                for (std::size_t done = 0; done < size;) {
+                    ssize_t written = ::pwrite(fd, bytes + done, size - done, static_cast<off_t>(extent.offset + done));
+
+                    if (written == -1) {
+                        if (errno == EINTR)
+                            continue;
+
+                        throw std::system_error(errno, std::generic_category(), "pwrite");
+                    }
+
+                    done += static_cast<std::size_t>(written);
+                }
+            }
+
+            void read(spill_extent extent, void* target, std::size_t size) {
+                auto* bytes = static_cast<std::byte*>(target);
+
+                for (std::size_t done = 0; done < size;) {
+                    ssize_t got = ::pread(fd, bytes + done, size - done, static_cast<off_t>(extent.offset + done));
+
+                    if (got == -1 and errno == EINTR)
+                        continue;
+
+                    if (got <= 0)
+                        throw std::system_error(got == 0 ? EIO : errno, std::generic_category(), "pread");
+
+                    done += static_cast<std::size_t>(got);
+                }
+            }
+
+            void count_spill(std::size_t size) noexcept {
+                spills.fetch_add(1, std::memory_order_relaxed);
+                spilledBytes.fetch_add(size, std::memory_order_relaxed);
+            }
+
+            void count_load(std::size_t size) noexcept {
+                loads.fetch_add(1, std::memory_order_relaxed);
+                spilledBytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            // A spilled object destroyed without being loaded again
+            void forget(std::size_t size) noexcept {
+                spilledBytes.fetch_sub(size, std::memory_order_relaxed);
+            }
+
+            std::uint64_t spill_count() const noexcept { return spills.load(std::memory_order_relaxed); }
+            std::uint64_t load_count() const noexcept { return loads.load(std::memory_order_relaxed); }
+            std::uint64_t spilled_bytes() const noexcept { return spilledBytes.load(std::memory_order_relaxed); }
+
+            std::uint64_t file_size() noexcept {
+                std::scoped_lock lock(extentMutex);
+                return end;
+            }
+        };
+
+        inline std::size_t page_size() noexcept {
+            static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+            return page;
+        }
+
+        // T lives in its own anonymous mapping, so spilling can drop its pages
+        // while keeping its address reserved for views
+        template<typename T, typename AP>
+        class omni_spill_block final : public omni_block_base {
+            omni_spill_state* state;
+            std::size_t mappedSize;
+            spill_extent extent;
+            std::size_t spilledSize = 0;
+
+            omni_spill_block(omni_spill_state* state, void* storage, std::size_t mappedSize)
+            : omni_block_base(reinterpret_cast<uintptr_t>(storage)), state(state), mappedSize(mappedSize) {
+                state->acquire();
+            }
+
+            ~omni_spill_block() noexcept override {
+                state->free(extent);
+                state->release();
+            }
+
+            void* storage() const noexcept {
+                return reinterpret_cast<void*>(originalPointer);
+            }
+
+            void materialize() override {
+                if constexpr (std::is_trivially_copyable_v<T>) {
+                    state->read(extent, storage(), spilledSize);
+                } else {
+                    std::string bytes(spilledSize, '\0');
+                    state->read(extent, bytes.data(), spilledSize);
+
+                    std::istringstream in(std::move(bytes), std::ios::binary);
+                    ::new(storage()) T(T::unspill(in));
+                }
+
+                state->count_load(spilledSize);
+            }
+
+            public:
+            template<typename... Args>
+            static omni_spill_block* make(omni_spill_state* state, Args&&... args) {
+                std::size_t mappedSize = round_up_to_nearest_multiple(AlignmentPolicy::get_stored_size<T, AP>(), page_size());
+
+                void* storage = ::mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+                if (storage == MAP_FAILED)
+                    throw std::system_error(errno, std::generic_category(), "mmap");
+
+                try {
+                    ::new(storage) T(std::forward<Args>(args)...);
+                } catch (...) {
+                    ::munmap(storage, mappedSize);
+                    throw;
+                }
+
+                try {
+                    return new omni_spill_block(state, storage, mappedSize);
+                } catch (...) {
+                    std::destroy_at(static_cast<T*>(storage));
+                    ::munmap(storage, mappedSize);
+                    throw;
+                }
+            }
+
+            T* get() const noexcept { return static_cast<T*>(storage()); }
+
+            // Returns the bytes written, or 0 if T was already spilled.
+            // If writing fails T stays resident and the error propagates.
+            std::size_t spill() {
+                if (is_pending())
+                    return 0;
+
+                std::string bytes;
+                const void* source = get();
+                std::size_t size = sizeof(T);
+
+                if constexpr (not std::is_trivially_copyable_v<T>) {
+                    std::ostringstream out(std::ios::binary);
+                    get()->spill(out);
+
+                    bytes = std::move(out).str();
+                    source = bytes.data();
+                    size = bytes.size();
+                }
+
+                if (size > extent.capacity) {
+                    spill_extent larger = state->reserve(size);
+                    state->free(std::exchange(extent, larger));
+                }
+
+                state->write(extent, source, size);
+
+                std::destroy_at(get());
+                ::madvise(storage(), mappedSize, MADV_DONTNEED);
+
+                spilledSize = size;
+                state->count_spill(size);
+                mark_pending();
+
+                return size;
+            }
+
+            void call_deleter() noexcept override {
+                if (is_pending()) {
+                    state->forget(spilledSize);
+                    clear_pending();
+                } else
+                    std::destroy_at(get());
+            }
+
+            void delete_allocation() noexcept override {
+                omni_spill_block* alloc = this;
+
+                ::munmap(alloc->storage(), alloc->mappedSize);
+
+                alloc->~omni_spill_block();
+                ::operator delete(alloc, sizeof(omni_spill_block));
+            }
+        };
+    }
+
+    // Spill file for omni_spillable objects. Objects may outlive it,
+    // the file is closed once the last of them is gone.
+    class omni_spill_file {
+        detail::omni_spill_state* state;
+
+        public:
+        // Creates an anonymous file in directory, which throws std::system_error if it cannot
+        explicit omni_spill_file(const std::filesystem::path& directory = std::filesystem::temp_directory_path())
+        : state(new detail::omni_spill_state(directory)) { }
+
+        omni_spill_file(const omni_spill_file&) = delete;
+        omni_spill_file& operator=(const omni_spill_file&) = delete;
+
+        ~omni_spill_file() {
+            state->release();
+        }
+
+        std::uint64_t spill_count() const noexcept {
+            return state->spill_count();
+        }
+
+        std::uint64_t load_count() const noexcept {
+            return state->load_count();
+        }
+
+        // Bytes held by objects currently spilled
+        std::uint64_t spilled_bytes() const noexcept {
+            return state->spilled_bytes();
+        }
+
+        // Including extents freed for reuse
+        std::uint64_t file_size() const noexcept {
+            return state->file_size();
+        }
+
+        template<typename T, typename AP, typename... Args>
+        requires (not std::is_array_v<T> and omni_spill_serializable<T> and std::constructible_from<T, Args&&...>)
+        friend omni_spillable<T, AP> make_omni_spillable(omni_spill_file& file, Args&&... args);
+    };
+
+    // Owner of a T that can be spilled. Views minted from it are ordinary omni_view/omni_ref.
+    // It wraps rather than derives from omni_ptr<T>, so it cannot be sliced into an owner
+    // that bypasses spilling.
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    class omni_spillable {
+        using owner_t = omni_ptr<T, AP>;
+        using block_t = detail::omni_spill_block<T, AP>;
+
+        owner_t owner;
+
+        explicit omni_spillable(owner_t&& owner) noexcept : owner(std::move(owner)) { }
+
+        block_t* block() const noexcept {
+            return static_cast<block_t*>(detail::get_control_block(owner));
+        }
+
+        public:
+        using element_type = T;
+        using pointer = typename owner_t::pointer;
+
+        constexpr omni_spillable() noexcept = default;
+        constexpr omni_spillable(std::nullptr_t) noexcept { }
+
+        omni_spillable(omni_spillable&&) noexcept = default;
+        omni_spillable& operator=(omni_spillable&&) noexcept = default;
+
+        // Writes T out and frees its memory. Returns the bytes written,
+        // or 0 if there is nothing to spill.
+        std::size_t spill() const {
+            return block() == nullptr ? 0 : block()->spill();
+        }
+
+        // Reads T back in now instead of on the next dereference
+        void load() const {
+            if (auto* control = block())
+                control->materialize_if_pending();
+        }
+
+        bool is_resident() const noexcept {
+            auto* control = block();
+            return control != nullptr and not control->is_pending();
+        }
+
+        pointer get() const {
+            load();
+            return detail::get_data_raw(owner);
+        }
+
+        T& operator*() const {
+            return *get();
+        }
+
+        pointer operator->() const {
+            return get();
+        }
+
+        void reset() noexcept {
+            owner.reset();
+        }
+
+        void swap(omni_spillable& other) noexcept {
+            owner.swap(other.owner);
+        }
+
+        long use_count() const noexcept {
+            return owner.use_count();
+        }
+
+        explicit operator bool() const noexcept {
+            return owner != nullptr;
+        }
+
+        friend bool operator==(const omni_spillable& spillable, std::nullptr_t) noexcept {
+            return spillable.owner == nullptr;
+        }
+
+        operator omni_view<T, AP>() const noexcept {
+            return omni_view<T, AP>(owner);
+        }
+
+        operator omni_ref<T, AP>() const noexcept {
+            return omni_ref<T, AP>(owner);
+        }
+
+        template<typename T2, typename AP2, typename... Args>
+        requires (not std::is_array_v<T2> and omni_spill_serializable<T2> and std::constructible_from<T2, Args&&...>)
+        friend omni_spillable<T2, AP2> make_omni_spillable(omni_spill_file& file, Args&&... args);
+    };
+
+    template<typename T, typename AP, typename... Args>
+    requires (not std::is_array_v<T> and omni_spill_serializable<T> and std::constructible_from<T, Args&&...>)
+    omni_spillable<T, AP> make_omni_spillable(omni_spill_file& file, Args&&... args) {
+        static_assert(lazy_construction<std::remove_cv_t<T>>, "Specialize DxPtr::lazy_construction<T> to make T spillable");
+        static_assert(static_cast<std::size_t>(AP{}.template get_alignment<T>()) <= 4096, "Spillable objects are page aligned at most");
+
+        using block_t = detail::omni_spill_block<T, AP>;
+
+        auto* block = block_t::make(file.state, std::forward<Args>(args)...);
+
+        return omni_spillable<T, AP>(detail::make_omni_ptr_raw<omni_ptr<T, AP>>(block->get(), block));
+    }
+}
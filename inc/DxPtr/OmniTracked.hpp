@@ -0,0 +1,478 @@
+#pragma once
+
+#include "DxPtr.hpp"
+
+// Tracked omni pointers are an alternative to the tombstone model of omni_ptr.
+// Every tracked view/ref links itself into an intrusive list hanging off the
+// owner's control block. When the owner is reset, it walks that list, nulls out
+// every view, and frees the whole allocation immediately. There is no refcount,
+// so nothing outlives the owner, but copying a view costs a list insertion.
+// Tracked pointers are not thread safe.
+
+namespace DxPtr {
+    template<typename T, typename AP>
+    class omni_tracked_ptr;
+
+    template<typename T, typename AP, typename... Args>
+    requires (not std::is_array_v<T> and DxPtr::detail::correct_constructor_args<T, Args...>)
+    omni_tracked_ptr<T, AP> make_omni_tracked(Args&&... args);
+
+    namespace detail {
+        class omni_tracked_block_base;
+
+        // Intrusive list node shared by every tracked view/ref.
+        // The stored address is untyped so that the control block can sever
+        // views of any type when the owner expires.
+        class tracked_link {
+            protected:
+            tracked_link* prev = nullptr;
+            tracked_link* next = nullptr;
+            void* address = nullptr;
+            omni_tracked_block_base* control = nullptr;
+
+            constexpr tracked_link() noexcept = default;
+            constexpr tracked_link(void* address, omni_tracked_block_base* control) noexcept
+            : address(address), control(control) { }
+
+            // Inserts this node directly after other
+            void link_after(tracked_link& other) noexcept {
+                prev = &other;
+                next = other.next;
+                other.next->prev = this;
+                other.next = this;
+            }
+
+            // Takes the place of other in its list, leaving other unlinked
+            void replace(tracked_link& other) noexcept {
+                prev = other.prev;
+                next = other.next;
+                prev->next = this;
+                next->prev = this;
+                other.prev = nullptr;
+                other.next = nullptr;
+            }
+
+            void unlink() noexcept {
+                if (prev == nullptr)
+                    return;
+
+                prev->next = next;
+                next->prev = prev;
+                prev = nullptr;
+                next = nullptr;
+            }
+
+            void sever() noexcept {
+                prev = nullptr;
+                next = nullptr;
+                address = nullptr;
+                control = nullptr;
+            }
+
+            friend class omni_tracked_block_base;
+        };
+
+        class omni_tracked_block_base {
+            // Sentinel of a circular list of every live view/ref
+            tracked_link views;
+
+            protected:
+            omni_tracked_block_base() noexcept {
+                views.prev = &views;
+                views.next = &views;
+            }
+
+            virtual ~omni_tracked_block_base() noexcept = default;
+
+            // Destroys the stored T and frees the allocation in one go
+            virtual void destroy() noexcept = 0;
+
+            public:
+            omni_tracked_block_base(const omni_tracked_block_base&) = delete;
+            omni_tracked_block_base& operator=(const omni_tracked_block_base&) = delete;
+
+            void track(tracked_link& link) noexcept {
+                link.link_after(views);
+            }
+
+            // Nulls out every view and frees everything immediately
+            void expire() noexcept {
+                tracked_link* node = views.next;
+
+                while (node != &views) {
+                    tracked_link* next = node->next;
+                    node->sever();
+                    node = next;
+                }
+
+                views.prev = &views;
+                views.next = &views;
+
+                destroy();
+            }
+
+            // Counts the owner plus every linked view, like omni_block_base::use_count
+            std::size_t use_count() const noexcept {
+                std::size_t count = 1;
+
+                for (const tracked_link* node = views.next; node != &views; node = node->next)
+                    count++;
+
+                return count;
+            }
+        };
+
+        template<typename T, bool IsConjoined = false, typename AP = AlignmentPolicy::Default>
+        requires AlignmentPolicy::interface<T, AP>
+        class omni_tracked_block final : public omni_tracked_block_base {
+            T* stored;
+
+            public:
+            omni_tracked_block(T* ptr) noexcept : stored(ptr) { }
+
+            T* get() const noexcept { return stored; }
+
+            // Buffer looks like [Control Padding Stored], same as omni_block
+            static constexpr std::size_t get_control_region_size() {
+                return round_up_to_nearest_multiple(
+                      sizeof(omni_tracked_block)
+                    , static_cast<std::size_t>(AP{}.template get_alignment<T>())
+                );
+            }
+
+            static constexpr std::align_val_t get_buffer_alignment() {
+                return std::max(
+                      static_cast<std::align_val_t>(alignof(omni_tracked_block))
+                    , AP{}.template get_alignment<T>()
+                );
+            }
+
+            static constexpr std::size_t get_buffer_size() {
+                return round_up_to_nearest_multiple(
+                      get_control_region_size() + AlignmentPolicy::get_stored_size<T, AP>()
+                    , static_cast<std::size_t>(get_buffer_alignment())
+                );
+            }
+
+            template<typename... Args>
+            requires IsConjoined
+            static omni_tracked_block* make_conjoined(Args&&... args) {
+                std::byte* buffer = static_cast<std::byte*>(
+                    detail::aligned_alloc(get_buffer_alignment(), get_buffer_size())
+                );
+
+                if (buffer == nullptr)
+                    throw std::bad_alloc();
+
+                T* stored;
+
+                try {
+                    stored = new(buffer + get_control_region_size()) T(std::forward<Args>(args)...);
+                } catch (...) {
+                    detail::aligned_free(buffer);
+                    throw;
+                }
+
+                return new(buffer) omni_tracked_block(stored);
+            }
+
+            private:
+            void destroy() noexcept override {
+                T* ptr = stored;
+
+                this->~omni_tracked_block();
+
+                if constexpr (IsConjoined) {
+                    ptr->~T();
+                    detail::aligned_free(this);
+                } else {
+                    delete ptr;
+                    ::operator delete(this, sizeof(omni_tracked_block));
+                }
+            }
+        };
+
+        // Non-owning tracked pointer. Copies link into the owner's list,
+        // moves take over the source's position in it.
+        template<typename T, typename AP = AlignmentPolicy::Default>
+        requires AlignmentPolicy::interface<T, AP>
+        class omni_tracked_weak : tracked_link {
+            public:
+            using element_type = T;
+            using pointer = element_type*;
+
+            private:
+            static void* erase(pointer ptr) noexcept {
+                return const_cast<void*>(static_cast<const void*>(ptr));
+            }
+
+            void attach(pointer ptr, omni_tracked_block_base* block) noexcept {
+                address = erase(ptr);
+                control = block;
+
+                if (control != nullptr)
+                    control->track(*this);
+            }
+
+            public:
+            constexpr omni_tracked_weak() noexcept = default;
+            constexpr omni_tracked_weak(std::nullptr_t) noexcept { }
+
+            // Copy constructor
+            omni_tracked_weak(const omni_tracked_weak& copy) noexcept : tracked_link() {
+                attach(copy.get(), copy.control);
+            }
+
+            // Move constructor
+            omni_tracked_weak(omni_tracked_weak&& move) noexcept
+            : tracked_link(move.address, move.control) {
+                if (control != nullptr)
+                    replace(move);
+
+                move.address = nullptr;
+                move.control = nullptr;
+            }
+
+            // Copy assignment
+            omni_tracked_weak& operator=(const omni_tracked_weak& copy) noexcept {
+                if (this == &copy)
+                    return *this;
+
+                unlink();
+                attach(copy.get(), copy.control);
+
+                return *this;
+            }
+
+            // Move assignment
+            omni_tracked_weak& operator=(omni_tracked_weak&& move) noexcept {
+                if (this == &move)
+                    return *this;
+
+                unlink();
+
+                address = move.address;
+                control = move.control;
+
+                if (control != nullptr)
+                    replace(move);
+
+                move.address = nullptr;
+                move.control = nullptr;
+
+                return *this;
+            }
+
+            ~omni_tracked_weak() {
+                unlink();
+            }
+
+            // Copy construct from owner or convertible tracked pointer
+            template<typename Y, typename AP2>
+            requires std::convertible_to<Y*, pointer>
+            omni_tracked_weak(const omni_tracked_weak<Y, AP2>& copy) noexcept {
+                attach(copy.get(), copy.control);
+            }
+
+            template<typename Y, typename AP2>
+            requires std::convertible_to<Y*, pointer>
+            omni_tracked_weak(const DxPtr::omni_tracked_ptr<Y, AP2>& owner) noexcept {
+                attach(owner.get(), owner.control);
+            }
+
+            template<typename Y, typename AP2>
+            requires std::convertible_to<Y*, pointer>
+            omni_tracked_weak& operator=(const omni_tracked_weak<Y, AP2>& copy) noexcept {
+                unlink();
+                attach(copy.get(), copy.control);
+
+                return *this;
+            }
+
+            template<typename Y, typename AP2>
+            requires std::convertible_to<Y*, pointer>
+            omni_tracked_weak& operator=(const DxPtr::omni_tracked_ptr<Y, AP2>& owner) noexcept {
+                unlink();
+                attach(owner.get(), owner.control);
+
+                return *this;
+            }
+
+            // Severed views have a null address, so no control block read is needed
+            pointer get() const noexcept {
+                return static_cast<pointer>(address);
+            }
+
+            void reset() noexcept {
+                unlink();
+                address = nullptr;
+                control = nullptr;
+            }
+
+            bool expired() const noexcept {
+                return control == nullptr;
+            }
+
+            long use_count() const noexcept {
+                if (control == nullptr)
+                    return 0;
+
+                return static_cast<long>(control->use_count());
+            }
+
+            T& operator*() const noexcept {
+                return *get();
+            }
+
+            pointer operator->() const noexcept {
+                return get();
+            }
+
+            explicit operator bool() const noexcept {
+                return not expired();
+            }
+
+            template<typename T2, typename AP2>
+            requires AlignmentPolicy::interface<T2, AP2>
+            friend class omni_tracked_weak;
+        };
+    }
+
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    class omni_tracked_ptr {
+        public:
+        using element_type = T;
+        using pointer = element_type*;
+
+        private:
+        template<bool IsConjoined = false>
+        using control_t = detail::omni_tracked_block<T, IsConjoined, AP>;
+
+        pointer data = nullptr;
+        detail::omni_tracked_block_base* control = nullptr;
+
+        omni_tracked_ptr(pointer ptr, detail::omni_tracked_block_base* control) noexcept
+        : data(ptr), control(control) { }
+
+        public:
+        constexpr omni_tracked_ptr() noexcept = default;
+        constexpr omni_tracked_ptr(std::nullptr_t) noexcept { }
+
+        explicit omni_tracked_ptr(pointer ptr)
+        : data(ptr), control(ptr == nullptr ? nullptr : new control_t<>(ptr)) { }
+
+        omni_tracked_ptr(const omni_tracked_ptr&) = delete;
+        omni_tracked_ptr& operator=(const omni_tracked_ptr&) = delete;
+
+        omni_tracked_ptr(omni_tracked_ptr&& move) noexcept
+        : data(std::exchange(move.data, nullptr)), control(std::exchange(move.control, nullptr)) { }
+
+        omni_tracked_ptr& operator=(omni_tracked_ptr&& move) noexcept {
+            if (this == &move)
+                return *this;
+
+            swap(move);
+
+            return *this;
+        }
+
+        ~omni_tracked_ptr() {
+            reset();
+        }
+
+        pointer get() const noexcept {
+            return data;
+        }
+
+        // Severs every tracked view and frees the allocation right away
+        void reset() noexcept {
+            if (control == nullptr)
+                return;
+
+            std::exchange(control, nullptr)->expire();
+            data = nullptr;
+        }
+
+        void reset(pointer other) {
+            omni_tracked_ptr(other).swap(*this);
+        }
+
+        long use_count() const noexcept {
+            if (control == nullptr)
+                return 0;
+
+            return static_cast<long>(control->use_count());
+        }
+
+        void swap(omni_tracked_ptr& other) noexcept {
+            std::swap(data, other.data);
+            std::swap(control, other.control);
+        }
+
+        T& operator*() const noexcept {
+            return *data;
+        }
+
+        pointer operator->() const noexcept {
+            return data;
+        }
+
+        explicit operator bool() const noexcept {
+            return data != nullptr;
+        }
+
+        template<typename T2, typename AP2>
+        requires AlignmentPolicy::interface<T2, AP2>
+        friend class detail::omni_tracked_weak;
+
+        template<typename T2, typename AP2, typename... Args>
+        requires (not std::is_array_v<T2> and detail::correct_constructor_args<T2, Args...>)
+        friend omni_tracked_ptr<T2, AP2> make_omni_tracked(Args&&... args);
+    };
+
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    class omni_tracked_view : public detail::omni_tracked_weak<const T, AP> {
+        using detail::omni_tracked_weak<const T, AP>::omni_tracked_weak;
+    };
+
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    omni_tracked_view(omni_tracked_ptr<T, AP>) -> omni_tracked_view<T, AP>;
+
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    class omni_tracked_ref : public detail::omni_tracked_weak<T, AP> {
+        using detail::omni_tracked_weak<T, AP>::omni_tracked_weak;
+    };
+
+    template<typename T, typename AP = AlignmentPolicy::Default>
+    omni_tracked_ref(omni_tracked_ptr<T, AP>) -> omni_tracked_ref<T, AP>;
+
+    template<typename T, typename AP = AlignmentPolicy::Default, typename... Args>
+    requires (not std::is_array_v<T> and detail::correct_constructor_args<T, Args...>)
+    omni_tracked_ptr<T, AP> make_omni_tracked(Args&&... args) {
+        using control_t = typename omni_tracked_ptr<T, AP>::template control_t<true>;
+
+        auto* block = control_t::make_conjoined(std::forward<Args>(args)...);
+
+        return omni_tracked_ptr<T, AP>(block->get(), block);
+    }
+
+    template<typename U, typename A, typename V, typename B>
+    bool operator==(const detail::omni_tracked_weak<U, A>& lhs, const detail::omni_tracked_weak<V, B>& rhs) noexcept {
+        return lhs.get() == rhs.get();
+    }
+
+    template<typename U, typename A, typename V, typename B>
+    bool operator==(const detail::omni_tracked_weak<U, A>& lhs, const omni_tracked_ptr<V, B>& rhs) noexcept {
+        return lhs.get() == rhs.get();
+    }
+
+    template<typename U, typename A>
+    bool operator==(const detail::omni_tracked_weak<U, A>& lhs, std::nullptr_t) noexcept {
+        return lhs.get() == nullptr;
+    }
+
+    template<typename U, typename A>
+    bool operator==(const omni_tracked_ptr<U, A>& lhs, std::nullptr_t) noexcept {
+        return lhs.get() == nullptr;
+    }
+}
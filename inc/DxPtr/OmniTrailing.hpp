@@ -0,0 +1,140 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <span>
+
+// A header followed by a variable-length array of elements in one conjoined buffer:
+// [Control Padding Header Padding Elem...]. Compared to a make_omni<Header> holding a
+// make_omni<Elem[]>, this saves an allocation, a control block and a pointer chase.
+
+namespace DxPtr {
+    template<typename Header, typename Elem, typename AP>
+    class omni_trailing_ptr;
+
+    namespace detail {
+        template<typename Header, typename Elem, typename AP>
+        class omni_trailing_block final : public omni_block_base {
+            static constexpr std::size_t align_header = static_cast<std::size_t>(AP{}.template get_alignment<Header>());
+            static constexpr std::size_t align_elem = static_cast<std::size_t>(AP{}.template get_alignment<Elem>());
+
+            std::size_t count;
+
+            omni_trailing_block(Header* header, std::size_t count) noexcept
+            : omni_block_base(reinterpret_cast<uintptr_t>(header)), count(count) { }
+
+            ~omni_trailing_block() noexcept override = default;
+
+            // Only the total size depends on the element count
+            static constexpr std::align_val_t get_alignment() noexcept {
+                return std::align_val_t(std::max({ alignof(omni_trailing_block), align_header, align_elem }));
+            }
+
+            static constexpr std::size_t get_header_offset() noexcept {
+                return round_up_to_nearest_multiple(sizeof(omni_trailing_block), align_header);
+            }
+
+            static constexpr std::size_t get_elements_offset() noexcept {
+                return round_up_to_nearest_multiple(get_header_offset() + AlignmentPolicy::get_stored_size<Header, AP>(), align_elem);
+            }
+
+            static std::size_t get_total_size(std::size_t count) {
+                if (count > (std::numeric_limits<std::size_t>::max() - get_elements_offset()) / sizeof(Elem))
+                    throw std::bad_array_new_length();
+
+                return get_elements_offset() + count * sizeof(Elem);
+            }
+
+            std::byte* buffer() noexcept { return reinterpret_cast<std::byte*>(this); }
+
+            public:
+            template<typename... Args>
+            static omni_trailing_block* make(std::size_t count, Args&&... args) {
+                std::size_t totalSize = get_total_size(count);
+                auto* buffer = static_cast<std::byte*>(aligned_allocator{}.allocate(get_alignment(), totalSize));
+
+                Header* header = nullptr;
+                Elem* elements = reinterpret_cast<Elem*>(buffer + get_elements_offset());
+
+                try {
+                    header = ::new(buffer + get_header_offset()) Header(std::forward<Args>(args)...);
+                    std::uninitialized_value_construct_n(elements, count);
+                } catch (...) {
+                    if (header != nullptr)
+                        header->~Header();
+
+                    aligned_allocator{}.deallocate(buffer, get_alignment(), totalSize);
+                    throw;
+                }
+
+                return ::new(buffer) omni_trailing_block(header, count);
+            }
+
+            Header* get() noexcept {
+                return std::launder(reinterpret_cast<Header*>(buffer() + get_header_offset()));
+            }
+
+            std::span<Elem> trailing() noexcept {
+                return { std::launder(reinterpret_cast<Elem*>(buffer() + get_elements_offset())), count };
+            }
+
+            // Elements go first, in reverse order of construction, then the header
+            void call_deleter() noexcept override {
+                std::span<Elem> elements = trailing();
+
+                for (std::size_t i = elements.size(); i > 0; i--)
+                    elements[i - 1].~Elem();
+
+                get()->~Header();
+            }
+
+            void delete_allocation() noexcept override {
+                omni_trailing_block* alloc = this;
+                std::size_t totalSize = get_elements_offset() + count * sizeof(Elem);
+
+                alloc->~omni_trailing_block();
+                aligned_allocator{}.deallocate(alloc, get_alignment(), totalSize);
+            }
+        };
+    }
+
+    // Owner of a Header with count trailing elements. Views of it are ordinary omni_view<Header>.
+    template<typename Header, typename Elem, typename AP = AlignmentPolicy::Default>
+    class omni_trailing_ptr : public omni_ptr<Header, AP> {
+        using base_t = omni_ptr<Header, AP>;
+        using block_t = detail::omni_trailing_block<Header, Elem, AP>;
+
+        explicit omni_trailing_ptr(base_t&& owner) noexcept : base_t(std::move(owner)) { }
+
+        public:
+        constexpr omni_trailing_ptr() noexcept = default;
+        constexpr omni_trailing_ptr(std::nullptr_t) noexcept { }
+
+        omni_trailing_ptr(omni_trailing_ptr&&) noexcept = default;
+        omni_trailing_ptr& operator=(omni_trailing_ptr&&) noexcept = default;
+
+        // Empty once reset
+        std::span<Elem> trailing() const noexcept {
+            auto* control = detail::get_control_block(*this);
+
+            if (control == nullptr)
+                return {};
+
+            return static_cast<block_t*>(control)->trailing();
+        }
+
+        template<typename H2, typename E2, typename AP2, typename... Args>
+        requires (not std::is_array_v<H2> and not std::is_array_v<E2> and detail::correct_constructor_args<H2, Args...>)
+        friend omni_trailing_ptr<H2, E2, AP2> make_omni_trailing(std::size_t count, Args&&... args);
+    };
+
+    // Elements are value-initialized
+    template<typename Header, typename Elem, typename AP = AlignmentPolicy::Default, typename... Args>
+    requires (not std::is_array_v<Header> and not std::is_array_v<Elem> and detail::correct_constructor_args<Header, Args...>)
+    omni_trailing_ptr<Header, Elem, AP> make_omni_trailing(std::size_t count, Args&&... args) {
+        using block_t = detail::omni_trailing_block<Header, Elem, AP>;
+
+        auto* block = block_t::make(count, std::forward<Args>(args)...);
+
+        return omni_trailing_ptr<Header, Elem, AP>(detail::make_omni_ptr_raw<omni_ptr<Header, AP>>(block->get(), block));
+    }
+}
@@ -0,0 +1,308 @@
+#pragma once
+
+#include "OmniRelocate.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <initializer_list>
+#include <new>
+
+// Vectors tuned for trivially relocatable element types such as omni_ptr, omni_view and omni_ref.
+// Growth relocates elements with memcpy instead of running a move constructor and a destructor
+// per element, and heap storage of such types is grown in place with std::realloc when possible.
+
+namespace DxPtr {
+    namespace detail {
+        // realloc only guarantees alignof(std::max_align_t)
+        template<typename T>
+        inline constexpr bool is_reallocatable = is_trivially_relocatable_v<T> and alignof(T) <= alignof(std::max_align_t);
+
+        template<typename T>
+        T* allocate_elements(std::size_t count) {
+            if constexpr (is_reallocatable<T>) {
+                void* memory = std::malloc(count * sizeof(T));
+
+                if (memory == nullptr)
+                    throw std::bad_alloc();
+
+                return static_cast<T*>(memory);
+            } else {
+                return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(alignof(T))));
+            }
+        }
+
+        template<typename T>
+        void free_elements(T* elements) noexcept {
+            if constexpr (is_reallocatable<T>)
+                std::free(elements);
+            else
+                ::operator delete(elements, std::align_val_t(alignof(T)));
+        }
+
+        template<typename T, std::size_t N>
+        struct inline_elements {
+            alignas(T) std::byte buffer[N * sizeof(T)];
+
+            T* data() noexcept { return reinterpret_cast<T*>(buffer); }
+        };
+
+        template<typename T>
+        struct inline_elements<T, 0> {
+            T* data() noexcept { return nullptr; }
+        };
+    }
+
+    // Vector storing up to N elements inline before spilling to the heap
+    template<typename T, std::size_t N>
+    class omni_small_vector {
+        public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using reference = T&;
+        using const_reference = const T&;
+        using pointer = T*;
+        using const_pointer = const T*;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        private:
+        [[no_unique_address]] detail::inline_elements<T, N> local;
+
+        T* first;
+        size_type count = 0;
+        size_type cap = N;
+
+        bool is_inline() const noexcept {
+            return N != 0 and first == const_cast<omni_small_vector*>(this)->local.data();
+        }
+
+        void free_storage() noexcept {
+            if (not is_inline() and first != nullptr)
+                detail::free_elements(first);
+        }
+
+        void grow_to(size_type newCap) {
+            if constexpr (detail::is_reallocatable<T>) {
+                if (not is_inline()) {
+                    void* memory = std::realloc(static_cast<void*>(first), newCap * sizeof(T));
+
+                    if (memory == nullptr)
+                        throw std::bad_alloc();
+
+                    first = static_cast<T*>(memory);
+                    cap = newCap;
+                    return;
+                }
+            }
+
+            T* elements = detail::allocate_elements<T>(newCap);
+
+            if constexpr (is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+                uninitialized_relocate(first, first + count, elements);
+            } else {
+                // Copy so the vector is untouched if a constructor throws
+                try {
+                    std::uninitialized_copy(first, first + count, elements);
+                } catch (...) {
+                    detail::free_elements(elements);
+                    throw;
+                }
+
+                std::destroy(first, first + count);
+            }
+
+            free_storage();
+
+            first = elements;
+            cap = newCap;
+        }
+
+        size_type next_capacity(size_type needed) const noexcept {
+            return std::max({ needed, cap * 2, size_type(4) });
+        }
+
+        // Steals other's heap storage or relocates its inline elements into ours
+        void take(omni_small_vector& other) noexcept {
+            if (other.is_inline()) {
+                first = local.data();
+                cap = N;
+                count = other.count;
+                uninitialized_relocate(other.first, other.first + other.count, first);
+            } else {
+                first = other.first;
+                cap = other.cap;
+                count = other.count;
+                other.first = other.local.data();
+                other.cap = N;
+            }
+
+            other.count = 0;
+        }
+
+        public:
+        omni_small_vector() noexcept {
+            first = local.data();
+        }
+
+        omni_small_vector(std::initializer_list<T> init)
+        requires std::copy_constructible<T>
+        : omni_small_vector() {
+            reserve(init.size());
+            count = std::uninitialized_copy(init.begin(), init.end(), first) - first;
+        }
+
+        omni_small_vector(const omni_small_vector& copy)
+        requires std::copy_constructible<T>
+        : omni_small_vector() {
+            reserve(copy.count);
+            count = std::uninitialized_copy(copy.begin(), copy.end(), first) - first;
+        }
+
+        omni_small_vector(omni_small_vector&& move) noexcept
+        requires (is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+            take(move);
+        }
+
+        omni_small_vector& operator=(const omni_small_vector& copy)
+        requires std::copy_constructible<T> {
+            if (this == &copy)
+                return *this;
+
+            clear();
+            reserve(copy.count);
+            count = std::uninitialized_copy(copy.begin(), copy.end(), first) - first;
+
+            return *this;
+        }
+
+        omni_small_vector& operator=(omni_small_vector&& move) noexcept
+        requires (is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+            if (this == &move)
+                return *this;
+
+            clear();
+            free_storage();
+            take(move);
+
+            return *this;
+        }
+
+        ~omni_small_vector() {
+            std::destroy(first, first + count);
+            free_storage();
+        }
+
+        void reserve(size_type newCap) {
+            if (newCap > cap)
+                grow_to(newCap);
+        }
+
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (count < cap)
+                return *std::construct_at(first + count++, std::forward<Args>(args)...);
+
+            // Build the element before growing, args may refer into this vector
+            if constexpr (is_trivially_relocatable_v<T>) {
+                alignas(T) std::byte staging[sizeof(T)];
+                T* element = std::construct_at(reinterpret_cast<T*>(staging), std::forward<Args>(args)...);
+
+                try {
+                    grow_to(next_capacity(count + 1));
+                } catch (...) {
+                    std::destroy_at(element);
+                    throw;
+                }
+
+                return *omni_relocate(element, first + count++);
+            } else {
+                T element(std::forward<Args>(args)...);
+
+                grow_to(next_capacity(count + 1));
+
+                return *std::construct_at(first + count++, std::move(element));
+            }
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        void pop_back() noexcept {
+            std::destroy_at(first + --count);
+        }
+
+        // Shifts the tail down by relocation rather than move assignment.
+        // If a move constructor throws, the elements not yet shifted are destroyed
+        // and the vector keeps those before them.
+        iterator erase(const_iterator pos) {
+            T* target = first + (pos - first);
+            T* last = first + count;
+
+            std::destroy_at(target);
+
+            if constexpr (is_trivially_relocatable_v<T> or std::is_nothrow_move_constructible_v<T>) {
+                uninitialized_relocate(target + 1, last, target);
+            } else {
+                T* dest = target;
+
+                try {
+                    for (; dest + 1 != last; ++dest)
+                        omni_relocate(dest + 1, dest);
+                } catch (...) {
+                    std::destroy(dest + 1, last);
+                    count = dest - first;
+                    throw;
+                }
+            }
+
+            count--;
+
+            return target;
+        }
+
+        void resize(size_type newSize)
+        requires std::default_initializable<T> {
+            if (newSize < count) {
+                std::destroy(first + newSize, first + count);
+                count = newSize;
+                return;
+            }
+
+            reserve(newSize);
+            std::uninitialized_value_construct(first + count, first + newSize);
+            count = newSize;
+        }
+
+        void clear() noexcept {
+            std::destroy(first, first + count);
+            count = 0;
+        }
+
+        size_type size() const noexcept { return count; }
+        size_type capacity() const noexcept { return cap; }
+        bool empty() const noexcept { return count == 0; }
+
+        T* data() noexcept { return first; }
+        const T* data() const noexcept { return first; }
+
+        iterator begin() noexcept { return first; }
+        iterator end() noexcept { return first + count; }
+        const_iterator begin() const noexcept { return first; }
+        const_iterator end() const noexcept { return first + count; }
+
+        T& operator[](size_type index) noexcept { return first[index]; }
+        const T& operator[](size_type index) const noexcept { return first[index]; }
+
+        T& front() noexcept { return first[0]; }
+        const T& front() const noexcept { return first[0]; }
+        T& back() noexcept { return first[count - 1]; }
+        const T& back() const noexcept { return first[count - 1]; }
+    };
+
+    template<typename T>
+    using omni_vector = omni_small_vector<T, 0>;
+
+    // The heap storage and size members hold no self references,
+    // but the inline buffer of a small vector does
+    template<typename T>
+    struct is_trivially_relocatable<omni_small_vector<T, 0>> : std::true_type { };
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include "DxPtr.hpp"
+#include <bit>
+#include <optional>
+#include <vector>
+
+// Side tables keyed by objects the table does not own. omni_weak_map<T, V> holds an
+// omni_view of each key and compares keys by owner identity, so an entry whose owner
+// expired never collides with a live one. Such entries are dropped incrementally:
+// every insert or erase sweeps a few more slots, and lookups drop the entry they land on.
+//
+// The table is open addressed with linear probing and backward-shift deletion,
+// so there are no tombstones to clean up.
+// Like the standard containers, it is not thread safe.
+
+namespace DxPtr {
+    template<typename T, typename V, typename AP = AlignmentPolicy::Default>
+    class omni_weak_map {
+        struct entry {
+            omni_view<T, AP> key;
+            V value;
+        };
+
+        static constexpr std::size_t min_capacity = 16;
+
+        // Slots examined per insert or erase, enough to sweep the table
+        // once before it fills up again at the maximum load factor
+        static constexpr std::size_t default_purge_budget = 2;
+
+        std::vector<std::optional<entry>> slots;
+        std::size_t count = 0;
+        std::size_t purgeCursor = 0;
+        std::size_t purgeBudget = default_purge_budget;
+
+        // The control block outlives the owner while the entry's view holds it,
+        // so an expired key's identity cannot be reused by a new owner
+        template<typename K>
+        static const void* identity_of(const K& key) noexcept {
+            return detail::get_control_block(key);
+        }
+
+        std::size_t mask() const noexcept {
+            return slots.size() - 1;
+        }
+
+        // Fibonacci hashing spreads the low, alignment-zeroed bits of block addresses
+        std::size_t home_of(const void* identity) const noexcept {
+            auto bits = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(identity));
+            return static_cast<std::size_t>((bits * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(slots.size())));
+        }
+
+        std::size_t distance(std::size_t home, std::size_t index) const noexcept {
+            return (index - home) & mask();
+        }
+
+        // Index of the entry for identity, or of the empty slot ending its probe
+        std::size_t probe(const void* identity) const noexcept {
+            std::size_t index = home_of(identity);
+
+            while (slots[index] and identity_of(slots[index]->key) != identity)
+                index = (index + 1) & mask();
+
+            return index;
+        }
+
+        // Backward shift: pulls later entries of the same run into the hole
+        void remove_at(std::size_t hole) noexcept {
+            slots[hole].reset();
+            count--;
+
+            std::size_t index = (hole + 1) & mask();
+
+            while (slots[index]) {
+                std::size_t home = home_of(identity_of(slots[index]->key));
+
+                if (distance(home, hole) < distance(home, index)) {
+                    slots[hole] = std::move(slots[index]);
+                    slots[index].reset();
+                    hole = index;
+                }
+
+                index = (index + 1) & mask();
+            }
+        }
+
+        void rehash(std::size_t capacity) {
+            std::vector<std::optional<entry>> old(capacity);
+            old.swap(slots);
+
+            count = 0;
+            purgeCursor = 0;
+
+            for (auto& slot : old) {
+                if (slot and not slot->key.expired()) {
+                    slots[probe(identity_of(slot->key))] = std::move(slot);
+                    count++;
+                }
+            }
+        }
+
+        // Keeps the load factor at or below 3/4
+        void reserve_one() {
+            if (slots.empty()) {
+                slots.resize(min_capacity);
+                return;
+            }
+
+            if ((count + 1) * 4 <= slots.size() * 3)
+                return;
+
+            // Dropping the dead may be enough, otherwise rehash into a table twice the size
+            purge();
+
+            if ((count + 1) * 4 > slots.size() * 3)
+                rehash(slots.size() * 2);
+        }
+
+        public:
+        using key_type = omni_view<T, AP>;
+        using mapped_type = V;
+        using size_type = std::size_t;
+
+        omni_weak_map() = default;
+
+        // Slots swept per insert or erase. 0 leaves purging to purge() and purge_some().
+        explicit omni_weak_map(size_type purgeBudget) : purgeBudget(purgeBudget) { }
+
+        // Null keys and keys already expired are rejected
+        template<typename K, typename... Args>
+        requires std::constructible_from<key_type, const K&> and std::constructible_from<V, Args&&...>
+        std::pair<V*, bool> try_emplace(const K& key, Args&&... args) {
+            if (key == nullptr)
+                throw std::invalid_argument("omni_weak_map key is null or expired");
+
+            purge_some(purgeBudget);
+            reserve_one();
+
+            std::size_t index = probe(identity_of(key));
+
+            if (slots[index])
+                return { &slots[index]->value, false };
+
+            slots[index].emplace(entry{ key_type(key), V(std::forward<Args>(args)...) });
+            count++;
+
+            return { &slots[index]->value, true };
+        }
+
+        template<typename K, typename U>
+        requires std::constructible_from<key_type, const K&> and std::assignable_from<V&, U&&>
+        std::pair<V*, bool> insert_or_assign(const K& key, U&& value) {
+            auto [stored, inserted] = try_emplace(key, std::forward<U>(value));
+
+            if (not inserted)
+                *stored = std::forward<U>(value);
+
+            return { stored, inserted };
+        }
+
+        template<typename K>
+        requires std::constructible_from<key_type, const K&> and std::default_initializable<V>
+        V& operator[](const K& key) {
+            return *try_emplace(key).first;
+        }
+
+        // Null if the key is absent or its owner expired, in which case the entry is dropped
+        template<typename K>
+        requires std::constructible_from<key_type, const K&>
+        V* find(const K& key) {
+            if (count == 0 or identity_of(key) == nullptr)
+                return nullptr;
+
+            std::size_t index = probe(identity_of(key));
+
+            if (not slots[index])
+                return nullptr;
+
+            if (slots[index]->key.expired()) {
+                remove_at(index);
+                return nullptr;
+            }
+
+            return &slots[index]->value;
+        }
+
+        // Does not drop anything, so expired entries are only skipped
+        template<typename K>
+        requires std::constructible_from<key_type, const K&>
+        const V* find(const K& key) const {
+            if (count == 0 or identity_of(key) == nullptr)
+                return nullptr;
+
+            std::size_t index = probe(identity_of(key));
+
+            if (not slots[index] or slots[index]->key.expired())
+                return nullptr;
+
+            return &slots[index]->value;
+        }
+
+        template<typename K>
+        requires std::constructible_from<key_type, const K&>
+        bool contains(const K& key) const {
+            return find(key) != nullptr;
+        }
+
+        template<typename K>
+        requires std::constructible_from<key_type, const K&>
+        bool erase(const K& key) {
+            purge_some(purgeBudget);
+
+            if (count == 0 or identity_of(key) == nullptr)
+                return false;
+
+            std::size_t index = probe(identity_of(key));
+
+            if (not slots[index])
+                return false;
+
+            bool live = not slots[index]->key.expired();
+            remove_at(index);
+
+            return live;
+        }
+
+        // Examines up to budget slots from where the last sweep stopped,
+        // dropping expired entries. Returns how many were dropped.
+        size_type purge_some(size_type budget) noexcept {
+            if (slots.empty())
+                return 0;
+
+            size_type dropped = 0;
+            budget = std::min(budget, slots.size());
+
+            for (; budget > 0; budget--) {
+                auto& slot = slots[purgeCursor];
+
+                // A backward shift may pull another entry into this slot, so it is checked again
+                if (slot and slot->key.expired()) {
+                    remove_at(purgeCursor);
+                    dropped++;
+                    continue;
+                }
+
+                purgeCursor = (purgeCursor + 1) & mask();
+            }
+
+            return dropped;
+        }
+
+        // Drops every expired entry
+        size_type purge() noexcept {
+            size_type dropped = 0;
+
+            // Starting at an empty slot, no run wraps around behind the sweep,
+            // so a backward shift never pulls an entry into a slot already swept
+            std::size_t start = 0;
+
+            while (start < slots.size() and slots[start])
+                start++;
+
+            for (std::size_t i = 0; i < slots.size(); i++) {
+                std::size_t index = (start + i) & mask();
+
+                while (slots[index] and slots[index]->key.expired()) {
+                    remove_at(index);
+                    dropped++;
+                }
+            }
+
+            return dropped;
+        }
+
+        // Calls fn(key, value) for every entry whose owner is alive
+        template<typename Fn>
+        void for_each(Fn&& fn) {
+            for (auto& slot : slots) {
+                if (slot and not slot->key.expired())
+                    fn(std::as_const(slot->key), slot->value);
+            }
+        }
+
+        void clear() noexcept {
+            for (auto& slot : slots)
+                slot.reset();
+
+            count = 0;
+            purgeCursor = 0;
+        }
+
+        // Includes entries whose owner expired but which were not dropped yet
+        size_type size() const noexcept {
+            return count;
+        }
+
+        bool empty() const noexcept {
+            return count == 0;
+        }
+
+        size_type capacity() const noexcept {
+            return slots.size();
+        }
+    };
+}
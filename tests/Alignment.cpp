@@ -28,4 +28,87 @@ TEMPLATE_TEST_CASE_SIG("Basic alignment checks", "[alignment]", ((std::size_t A)
         REQUIRE(IsAligned(omni.get(), A));
     }
     
-}
\ No newline at end of file
+}
+
+struct HotCounter {
+    long value = 0;
+};
+
+template<>
+inline constexpr bool DxPtr::AlignmentPolicy::isolate<HotCounter> = true;
+
+bool SharesCacheLine(const void* a, const void* b) {
+    return reinterpret_cast<uintptr_t>(a) / detail::cache_line_size
+        == reinterpret_cast<uintptr_t>(b) / detail::cache_line_size;
+}
+
+TEST_CASE("Cache isolated alignment", "[alignment]") {
+    SECTION("Explicit policy") {
+        auto omni = make_omni<Aligner<1>, AlignmentPolicy::CacheIsolated>('C');
+        auto* control = detail::get_control_block(omni);
+
+        REQUIRE(IsAligned(omni.get(), detail::cache_line_size));
+        REQUIRE(not SharesCacheLine(control, omni.get()));
+        REQUIRE(omni->c == 'C');
+    }
+
+    SECTION("Type opted in through Default") {
+        auto omni = make_omni<HotCounter>();
+        auto* control = detail::get_control_block(omni);
+
+        REQUIRE(IsAligned(omni.get(), detail::cache_line_size));
+        REQUIRE(not SharesCacheLine(control, omni.get()));
+    }
+
+    SECTION("Buffer info is padded to whole cache lines") {
+        using block_t = detail::omni_block<Aligner<1>, true, std::default_delete<Aligner<1>>, AlignmentPolicy::CacheIsolated>;
+        constexpr auto info = block_t::get_conjoined_buffer_info(sizeof(Aligner<1>));
+
+        REQUIRE(info.controlRegionSize % detail::cache_line_size == 0);
+        REQUIRE(info.storedRegionSize == detail::cache_line_size);
+        REQUIRE(static_cast<std::size_t>(info.alignment) == detail::cache_line_size);
+    }
+}
+
+TEST_CASE("Cache isolated arrays", "[alignment][arrays]") {
+    constexpr std::size_t count = 3;
+
+    auto omni = make_omni<HotCounter[]>(count);
+    auto* control = detail::get_control_block(omni);
+
+    SECTION("Array is isolated as a whole") {
+        REQUIRE(IsAligned(omni.get(), detail::cache_line_size));
+        REQUIRE(not SharesCacheLine(control, omni.get()));
+        REQUIRE(AlignmentPolicy::is_cache_isolated<HotCounter[], AlignmentPolicy::Default>());
+        REQUIRE(static_cast<std::size_t>(AlignmentPolicy::Default{}.get_alignment<HotCounter[]>()) == detail::cache_line_size);
+    }
+
+    SECTION("Elements keep their natural stride") {
+        for (std::size_t i = 0; i < count; i++)
+            omni[i].value = static_cast<long>(i);
+
+        REQUIRE(reinterpret_cast<std::byte*>(&omni[1]) - reinterpret_cast<std::byte*>(&omni[0]) == sizeof(HotCounter));
+        REQUIRE(omni[2].value == 2);
+    }
+
+    SECTION("Under the CacheIsolated policy") {
+        auto isolated = make_omni<int[], AlignmentPolicy::CacheIsolated>(4);
+
+        for (int i = 0; i < 4; i++)
+            isolated[i] = i;
+
+        REQUIRE(IsAligned(isolated.get(), detail::cache_line_size));
+        REQUIRE(not SharesCacheLine(detail::get_control_block(isolated), isolated.get()));
+        REQUIRE(&isolated[3] - &isolated[0] == 3);
+        REQUIRE(isolated[3] == 3);
+        REQUIRE(isolated.size() == 4);
+    }
+
+    SECTION("Only the whole array is padded") {
+        using block_t = detail::omni_block<HotCounter[], true>;
+        auto info = block_t::get_conjoined_buffer_info(AlignmentPolicy::get_stored_size<HotCounter[], AlignmentPolicy::Default>(count));
+
+        REQUIRE(AlignmentPolicy::get_stored_size<HotCounter[], AlignmentPolicy::Default>(count) == count * sizeof(HotCounter));
+        REQUIRE(info.storedRegionSize == detail::round_up_to_nearest_multiple(count * sizeof(HotCounter), detail::cache_line_size));
+    }
+}
@@ -0,0 +1,122 @@
+#include "OmniAtomic.hpp"
+#include "Common.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+TEMPLATE_PRODUCT_TEST_CASE("Atomic weak basic operations", "[atomic][basic]", (omni_view, omni_ref), (Ticker)) {
+    using weak_t = TestType;
+    TickerInfo infoA{}, infoB{};
+
+    auto a = make_omni<Ticker>(infoA, "A");
+    auto b = make_omni<Ticker>(infoB, "B");
+
+    SECTION("Default is empty") {
+        std::atomic<weak_t> atom;
+
+        REQUIRE(atom.load() == nullptr);
+        REQUIRE(atom.load().use_count() == 0);
+    }
+
+    SECTION("Load and store") {
+        std::atomic<weak_t> atom = weak_t(a);
+
+        REQUIRE(a.use_count() == 2);
+
+        {
+            weak_t loaded = atom.load();
+
+            REQUIRE(loaded == a);
+            REQUIRE(a.use_count() == 3);
+        }
+
+        atom.store(b);
+
+        REQUIRE(a.use_count() == 1);
+        REQUIRE(b.use_count() == 2);
+        REQUIRE(atom.load() == b);
+    }
+
+    SECTION("Exchange") {
+        std::atomic<weak_t> atom = weak_t(a);
+
+        weak_t old = atom.exchange(b);
+
+        REQUIRE(old == a);
+        REQUIRE(a.use_count() == 2);
+        REQUIRE(b.use_count() == 2);
+    }
+
+    SECTION("Compare exchange") {
+        std::atomic<weak_t> atom = weak_t(a);
+        weak_t expected = b;
+
+        REQUIRE(not atom.compare_exchange_strong(expected, b));
+        REQUIRE(expected == a);
+        REQUIRE(atom.load() == a);
+
+        REQUIRE(atom.compare_exchange_strong(expected, b));
+        REQUIRE(atom.load() == b);
+        REQUIRE(a.use_count() == 2);
+        REQUIRE(b.use_count() == 2);
+    }
+
+    SECTION("Observes expiry") {
+        std::atomic<weak_t> atom = weak_t(a);
+
+        a.reset();
+
+        REQUIRE(infoA == destroyed<>);
+        REQUIRE(atom.load().expired());
+        REQUIRE(atom.load().use_count() == 2);
+    }
+}
+
+TEST_CASE("Atomic view concurrent snapshots", "[atomic][threads]") {
+    constexpr int versions = 2000;
+    constexpr int readers = 4;
+
+    std::vector<omni_ptr<int>> owners;
+    owners.reserve(versions);
+
+    for (int i = 0; i < versions; i++)
+        owners.push_back(make_omni<int>(i));
+
+    std::atomic<omni_view<int>> current = omni_view<int>(owners[0]);
+    std::atomic<bool> done = false;
+    std::atomic<int> regressions = 0;
+
+    std::vector<std::thread> threads;
+
+    for (int r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            int last = 0;
+
+            while (not done.load()) {
+                omni_view<int> snapshot = current.load();
+                int value = *snapshot;
+
+                if (value < last)
+                    regressions++;
+
+                last = value;
+            }
+        });
+    }
+
+    for (int i = 1; i < versions; i++)
+        current.store(owners[i]);
+
+    done = true;
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(regressions == 0);
+    REQUIRE(owners[versions - 1].use_count() == 2);
+
+    for (int i = 0; i < versions - 1; i++)
+        REQUIRE(owners[i].use_count() == 1);
+}
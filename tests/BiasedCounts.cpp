@@ -0,0 +1,157 @@
+#include "DxPtr.hpp"
+#include "OmniBudget.hpp"
+#include "Common.hpp"
+
+#include <latch>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+TEST_CASE("Biased counts on the owner thread", "[biased][threads]") {
+    TickerInfo info{};
+    omni_ptr<Ticker> owner = make_omni<Ticker>(info, "A");
+
+    SECTION("Views copied on other threads") {
+        omni_view<Ticker> view = owner;
+        std::vector<std::thread> threads;
+        std::atomic<int> expiredCopies = 0;
+
+        for (int t = 0; t < 4; t++) {
+            threads.emplace_back([view, &expiredCopies] {
+                for (int i = 0; i < 1000; i++) {
+                    omni_view<Ticker> copy = view;
+
+                    if (copy.expired())
+                        expiredCopies++;
+                }
+            });
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+
+        REQUIRE(expiredCopies == 0);
+        REQUIRE(owner.use_count() == 2);
+
+        owner.reset();
+
+        REQUIRE(view.expired());
+    }
+
+    SECTION("Owner-thread view released on another thread") {
+        omni_view<Ticker> view = owner;
+
+        std::thread([moved = std::move(view)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(owner.use_count() == 1);
+
+        owner.reset();
+
+        REQUIRE(info == destroyed<>);
+    }
+
+    SECTION("Owner reset on another thread") {
+        omni_view<Ticker> view = owner;
+
+        std::thread([moved = std::move(owner)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(view.expired());
+        REQUIRE(info == destroyed<>);
+        REQUIRE(view.use_count() == 1);
+    }
+
+    REQUIRE(info == destroyed<>);
+}
+
+TEST_CASE("Biased counts outlive the owner thread", "[biased][threads]") {
+    TickerInfo info{};
+    omni_view<Ticker> view;
+
+    std::thread([&] {
+        auto owner = make_omni<Ticker>(info, "A");
+        view = owner;
+    }).join();
+
+    REQUIRE(view.expired());
+    REQUIRE(info == destroyed<>);
+    REQUIRE(view.use_count() == 1);
+
+    // Last reference dropped after the owner thread exited, merged by this thread
+    view.reset();
+
+    REQUIRE(view.use_count() == 0);
+}
+
+TEST_CASE("Remote releases free without the owner thread", "[biased][threads]") {
+    TickerInfo info{};
+    omni_budget budget;
+
+    SECTION("Owner expired before the last view is released elsewhere") {
+        omni_ptr<Ticker> owner = budget.make<Ticker>(info, "A");
+        omni_view<Ticker> view = owner;
+
+        owner.reset();
+
+        std::thread([moved = std::move(view)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(budget.live_bytes() == 0);
+    }
+
+    SECTION("View released elsewhere before the owner expires") {
+        omni_ptr<Ticker> owner = budget.make<Ticker>(info, "A");
+        omni_view<Ticker> view = owner;
+
+        std::thread([moved = std::move(view)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(budget.live_bytes() != 0);
+
+        owner.reset();
+
+        REQUIRE(budget.live_bytes() == 0);
+    }
+
+    SECTION("Owner thread stays alive without touching the block again") {
+        omni_ptr<Ticker> owner;
+        omni_view<Ticker> view;
+        std::latch made(1);
+        std::latch checked(1);
+
+        // Creates the block, then blocks until the test is done so that it can neither
+        // merge anything nor exit in the meantime
+        std::thread creator([&] {
+            owner = budget.make<Ticker>(info, "A");
+            view = owner;
+            made.count_down();
+            checked.wait();
+        });
+
+        made.wait();
+
+        std::thread([moved = std::move(owner)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(budget.live_bytes() != 0);
+
+        std::thread([moved = std::move(view)]() mutable {
+            moved.reset();
+        }).join();
+
+        REQUIRE(budget.live_bytes() == 0);
+
+        checked.count_down();
+        creator.join();
+    }
+
+    REQUIRE(info == destroyed<>);
+}
@@ -0,0 +1,69 @@
+#include "DxPtr.hpp"
+#include "Common.hpp"
+
+#include <numeric>
+#include <vector>
+
+using namespace DxPtr;
+
+#ifdef NDEBUG
+static_assert(sizeof(omni_borrow<int>) == sizeof(int*));
+#endif
+
+static int sum(omni_borrow<const std::vector<int>> values) {
+    return std::accumulate(values->begin(), values->end(), 0);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Borrowing from weak pointers", "[borrow][basic]", (omni_view, omni_ref), (Ticker)) {
+    using weak_t = TestType;
+    TickerInfo info{};
+
+    auto owner = make_omni<Ticker>(info, "A");
+    weak_t weak = owner;
+
+    SECTION("Borrow does not count") {
+        {
+            auto borrowed = weak.borrow();
+            auto copy = borrowed;
+
+            REQUIRE(borrowed);
+            REQUIRE(borrowed->str == "A");
+            REQUIRE((*copy).str == "A");
+            REQUIRE(borrowed.get() == owner.get());
+            REQUIRE(owner.use_count() == 2);
+        }
+
+        owner.reset();
+
+        REQUIRE(info == destroyed<>);
+    }
+
+    SECTION("Borrowing an expired object is empty") {
+        owner.reset();
+
+        auto borrowed = weak.borrow();
+
+        REQUIRE(not borrowed);
+        REQUIRE(borrowed.get() == nullptr);
+    }
+
+    SECTION("Borrowing an empty pointer is empty") {
+        weak_t empty;
+
+        REQUIRE(not empty.borrow());
+    }
+}
+
+TEST_CASE("Borrows as parameters", "[borrow][conversion]") {
+    auto owner = make_omni<std::vector<int>>(std::vector{ 1, 2, 3 });
+    omni_ref<std::vector<int>> ref = owner;
+    omni_view<std::vector<int>> view = owner;
+
+    omni_borrow<std::vector<int>> mutableBorrow = ref.borrow();
+    mutableBorrow->push_back(4);
+
+    REQUIRE(sum(mutableBorrow) == 10);
+    REQUIRE(sum(view.borrow()) == 10);
+    REQUIRE(sum(owner.borrow()) == 10);
+    REQUIRE(owner.use_count() == 3);
+}
@@ -0,0 +1,176 @@
+#include "OmniBudget.hpp"
+#include "Common.hpp"
+
+#include <list>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+namespace {
+    struct Texture {
+        std::byte pixels[1000];
+    };
+
+    struct Tenant { };
+}
+
+TEST_CASE("Budget charges whole buffers", "[budget][basic]") {
+    constexpr std::size_t charge = omni_budget::charge_of<Texture>();
+    static_assert(charge >= sizeof(Texture));
+
+    omni_budget budget(charge * 3);
+
+    auto first = budget.make<Texture>();
+    auto second = budget.make<Texture>();
+
+    REQUIRE(budget.live_bytes() == charge * 2);
+
+    // Views keep the buffer, and so the charge, after the owner expires
+    omni_view<Texture> view = first;
+    first.reset();
+    REQUIRE(budget.live_bytes() == charge * 2);
+
+    view.reset();
+    REQUIRE(budget.live_bytes() == charge);
+
+    auto third = budget.make<Texture>();
+    auto fourth = budget.make<Texture>();
+    REQUIRE(budget.live_bytes() == charge * 3);
+    REQUIRE(budget.peak_bytes() == charge * 3);
+
+    REQUIRE_THROWS_AS(budget.make<Texture>(), omni_budget_exceeded);
+    REQUIRE(budget.make<Texture>(std::nothrow) == nullptr);
+    REQUIRE(budget.live_bytes() == charge * 3);
+
+    // Lowering the limit refuses allocations until enough is freed
+    budget.set_limit(charge);
+    second.reset();
+    third.reset();
+
+    REQUIRE(budget.make<Texture>(std::nothrow) == nullptr);
+
+    fourth.reset();
+    REQUIRE(budget.make<Texture>(std::nothrow) != nullptr);
+    REQUIRE(budget.live_bytes() == 0);
+}
+
+TEST_CASE("Budget constructor failures", "[budget][errors]") {
+    struct Throws {
+        Throws(int) {
+            throw std::runtime_error("constructor");
+        }
+    };
+
+    omni_budget budget;
+
+    REQUIRE_THROWS_AS(budget.make<Throws>(1), std::runtime_error);
+    REQUIRE_THROWS_AS(budget.make<Throws>(std::nothrow, 1), std::runtime_error);
+    REQUIRE(budget.live_bytes() == 0);
+
+    TickerInfo info{};
+    auto ticker = budget.make<Ticker>(info, "budgeted");
+
+    REQUIRE(ticker->str == "budgeted");
+    ticker.reset();
+    REQUIRE(info == destroyed<>);
+}
+
+TEST_CASE("Budget eviction", "[budget][evict]") {
+    constexpr std::size_t charge = omni_budget::charge_of<Texture>();
+
+    omni_budget budget(charge * 4);
+
+    // Most recently used at the front
+    std::list<omni_ptr<Texture>> cache;
+    int evicted = 0;
+
+    budget.set_evictor([&](std::size_t needed) {
+        REQUIRE(needed == charge);
+
+        if (cache.empty())
+            return false;
+
+        cache.pop_back();
+        evicted++;
+
+        return true;
+    });
+
+    for (int i = 0; i < 10; i++)
+        cache.push_front(budget.make<Texture>());
+
+    REQUIRE(evicted == 6);
+    REQUIRE(cache.size() == 4);
+    REQUIRE(budget.live_bytes() == charge * 4);
+
+    // An evictor that runs dry fails the allocation
+    cache.clear();
+
+    omni_ptr<Texture> pinned[4];
+
+    for (auto& texture : pinned)
+        texture = budget.make<Texture>();
+
+    REQUIRE(budget.make<Texture>(std::nothrow) == nullptr);
+    REQUIRE_THROWS_AS(budget.make<Texture>(), omni_budget_exceeded);
+}
+
+TEST_CASE("Budget per tag", "[budget][tag]") {
+    omni_budget& tenant = omni_budget_for<Tenant>();
+
+    REQUIRE(&tenant == &omni_budget_for<Tenant>());
+    REQUIRE(&tenant != &omni_budget_for<Texture>());
+    REQUIRE(tenant.limit() == omni_budget::unlimited);
+
+    tenant.set_limit(omni_budget::charge_of<int>());
+
+    auto value = tenant.make<int>(5);
+    REQUIRE(tenant.make<int>(std::nothrow, 6) == nullptr);
+
+    tenant.set_limit(omni_budget::unlimited);
+}
+
+TEST_CASE("Budget across threads", "[budget][threads]") {
+    constexpr std::size_t charge = omni_budget::charge_of<Texture>();
+
+    omni_budget budget(charge * 8);
+    std::vector<std::thread> threads;
+    std::atomic<bool> overBudget = false;
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            std::vector<omni_ptr<Texture>> held;
+
+            for (int i = 0; i < 500; i++) {
+                auto texture = budget.make<Texture>(std::nothrow);
+
+                if (texture != nullptr)
+                    held.push_back(std::move(texture));
+
+                if (held.size() > 2)
+                    held.erase(held.begin());
+
+                if (budget.live_bytes() > charge * 8)
+                    overBudget = true;
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(not overBudget);
+    REQUIRE(budget.live_bytes() == 0);
+    REQUIRE(budget.peak_bytes() <= charge * 8);
+
+    // Budget outlived by a buffer still takes the charge back safely
+    omni_ptr<int> survivor;
+
+    {
+        omni_budget scoped;
+        survivor = scoped.make<int>(1);
+    }
+
+    survivor.reset();
+}
@@ -0,0 +1,138 @@
+#include "OmniBuffer.hpp"
+#include "Common.hpp"
+
+#include <numeric>
+#include <thread>
+
+using namespace DxPtr;
+
+TEST_CASE("Buffer basic use", "[buffer][basic]") {
+    auto buffer = make_omni_buffer<int>(4);
+
+    REQUIRE(buffer.size() == 4);
+    REQUIRE(buffer[3] == 0);
+
+    std::iota(buffer.begin(), buffer.end(), 1);
+    buffer.push_back(5);
+
+    omni_buffer_view<int> view = buffer;
+
+    REQUIRE(view.size() == 5);
+    REQUIRE(std::accumulate(view.begin(), view.end(), 0) == 15);
+    REQUIRE(buffer.use_count() == 2);
+
+    buffer.pop_back();
+    REQUIRE(view.size() == 4);
+
+    buffer.reset();
+
+    REQUIRE(view.expired());
+    REQUIRE(view.data() == nullptr);
+    REQUIRE(view.size() == 0);
+}
+
+TEST_CASE("Buffer views survive growth", "[buffer][growth]") {
+    auto buffer = make_omni_buffer<int>();
+    omni_buffer_ref<int> ref = buffer;
+    omni_buffer_view<int> view = ref;
+
+    buffer.push_back(42);
+
+    auto first = buffer.element(0);
+    omni_element_view<int> firstView = first;
+
+    const int* before = view.data();
+
+    // Enough to move the elements several times, and onto a mapping where supported
+    for (int i = 1; i < 100'000; i++)
+        buffer.push_back(i);
+
+    REQUIRE(view.size() == 100'000);
+    REQUIRE(view.data() == buffer.data());
+    REQUIRE(view.data() != before);
+    REQUIRE(view[99'999] == 99'999);
+
+    ref[1] = -1;
+    REQUIRE(buffer[1] == -1);
+
+    REQUIRE(*first == 42);
+    REQUIRE(firstView.get() == buffer.data());
+
+    #if DXPTR_HAS_MREMAP
+    REQUIRE(buffer.is_mapped());
+    #endif
+
+    auto last = view.element(99'999);
+    REQUIRE(last);
+
+    // Element views resolve to null once the buffer shrinks below their index
+    buffer.resize(10);
+
+    REQUIRE(not last);
+    REQUIRE(last.get() == nullptr);
+    REQUIRE(first);
+
+    buffer.reset();
+
+    REQUIRE(not first);
+    REQUIRE(ref.expired());
+}
+
+TEST_CASE("Buffer of non-trivial elements", "[buffer][lifetime]") {
+    TickerInfo info{};
+
+    {
+        auto buffer = make_omni_buffer<Ticker>();
+        omni_buffer_view<Ticker> view = buffer;
+
+        for (int i = 0; i < 20; i++)
+            buffer.emplace_back(info, std::to_string(i));
+
+        REQUIRE(info.constructed == 20);
+        REQUIRE(view[19].str == "19");
+        REQUIRE(view.element(7)->str == "7");
+
+        // Ticker's move constructor may throw, so growing copies the elements over
+        REQUIRE(info.copyConstructed > 0);
+
+        int made = info.constructed + info.copyConstructed + info.moveConstructed;
+        REQUIRE(info.destroyed == made - 20);
+
+        buffer.reset();
+
+        REQUIRE(view.expired());
+        REQUIRE(info.destroyed == made);
+    }
+}
+
+TEST_CASE("Buffer of omni pointers relocates them", "[buffer][growth]") {
+    auto target = make_omni<int>(7);
+    auto buffer = make_omni_buffer<omni_view<int>>();
+
+    for (int i = 0; i < 1000; i++)
+        buffer.push_back(target);
+
+    REQUIRE(target.use_count() == 1001);
+    REQUIRE(*buffer[999] == 7);
+
+    buffer.reset();
+
+    REQUIRE(target.use_count() == 1);
+}
+
+TEST_CASE("Buffer views released on other threads", "[buffer][threads]") {
+    auto buffer = make_omni_buffer<int>(16);
+    omni_buffer_view<int> view = buffer;
+
+    std::thread other([copy = view]() mutable {
+        omni_buffer_view<int> local = copy;
+        REQUIRE(local.size() == 16);
+    });
+
+    other.join();
+
+    REQUIRE(buffer.use_count() == 2);
+
+    buffer.reset();
+    REQUIRE(view.expired());
+}
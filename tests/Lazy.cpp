@@ -0,0 +1,153 @@
+#include "OmniLazy.hpp"
+#include "Common.hpp"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+struct Expensive {
+    TickerInfo* info;
+    std::string str;
+
+    Expensive(TickerInfo& info, std::string str) : info(&info), str(std::move(str)) {
+        this->info->constructed++;
+    }
+
+    ~Expensive() {
+        info->destroyed++;
+    }
+};
+
+struct Fragile {
+    Fragile(int& attempts) {
+        if (attempts++ == 0)
+            throw std::runtime_error("first attempt fails");
+    }
+};
+
+template<>
+inline constexpr bool DxPtr::lazy_construction<Expensive> = true;
+
+template<>
+inline constexpr bool DxPtr::lazy_construction<Fragile> = true;
+
+template<>
+inline constexpr bool DxPtr::lazy_construction<std::unique_ptr<int>> = true;
+
+TEST_CASE("Lazy construction on first access", "[lazy][basic]") {
+    TickerInfo info{};
+
+    auto owner = make_omni_lazy<Expensive>(std::ref(info), "A");
+    omni_view<Expensive> view = owner;
+
+    REQUIRE(info.constructed == 0);
+    REQUIRE(not owner.is_constructed());
+    REQUIRE(owner.use_count() == 2);
+
+    SECTION("Through the owner") {
+        REQUIRE(owner->str == "A");
+        REQUIRE(info.constructed == 1);
+        REQUIRE(owner.is_constructed());
+        REQUIRE(view->str == "A");
+        REQUIRE(info.constructed == 1);
+    }
+
+    SECTION("Through a view") {
+        REQUIRE(view->str == "A");
+        REQUIRE(info.constructed == 1);
+        REQUIRE(owner.is_constructed());
+    }
+
+    SECTION("Through get") {
+        omni_ref<Expensive> ref = owner;
+
+        REQUIRE(ref.get()->str == "A");
+        REQUIRE(info.constructed == 1);
+    }
+
+    SECTION("Never accessed is never constructed") {
+        owner.reset();
+
+        REQUIRE(view.expired());
+        REQUIRE(view.get() == nullptr);
+        REQUIRE(not detail::get_control_block(view)->is_pending());
+        REQUIRE(info.constructed == 0);
+        REQUIRE(info.destroyed == 0);
+    }
+
+    SECTION("Through an owner moved into a plain omni_ptr") {
+        omni_ptr<Expensive> plain = std::move(owner);
+
+        REQUIRE(plain->str == "A");
+        REQUIRE(info.constructed == 1);
+        REQUIRE((*plain).str == "A");
+        REQUIRE(plain.get() == view.get());
+        REQUIRE(info.constructed == 1);
+
+        plain.reset();
+
+        REQUIRE(info == destroyed<>);
+    }
+
+    SECTION("Expiry after construction destroys") {
+        owner.construct();
+        owner.reset();
+
+        REQUIRE(view.expired());
+        REQUIRE(view.get() == nullptr);
+        REQUIRE(info == destroyed<>);
+    }
+}
+
+TEST_CASE("Lazy arguments are kept until construction", "[lazy][arguments]") {
+    auto number = std::make_unique<int>(5);
+    int* address = number.get();
+
+    auto owner = make_omni_lazy<std::unique_ptr<int>>(std::move(number));
+
+    REQUIRE(number == nullptr);
+    REQUIRE(owner->get() == address);
+    REQUIRE(**owner == 5);
+}
+
+TEST_CASE("Lazy construction failure retries", "[lazy][exceptions]") {
+    int attempts = 0;
+
+    auto owner = make_omni_lazy<Fragile>(std::ref(attempts));
+
+    REQUIRE_THROWS(owner.construct());
+    REQUIRE(not owner.is_constructed());
+
+    owner.construct();
+
+    REQUIRE(owner.is_constructed());
+    REQUIRE(attempts == 2);
+}
+
+TEST_CASE("Lazy construction races", "[lazy][threads]") {
+    constexpr int threads = 8;
+    TickerInfo info{};
+
+    {
+        auto owner = make_omni_lazy<Expensive>(std::ref(info), "shared");
+        std::vector<omni_view<Expensive>> views(threads, omni_view<Expensive>(owner));
+        std::vector<std::thread> workers;
+        std::atomic<int> mismatches = 0;
+
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back([&, i] {
+                if (views[i]->str != "shared")
+                    mismatches++;
+            });
+        }
+
+        for (auto& worker : workers)
+            worker.join();
+
+        REQUIRE(mismatches == 0);
+    }
+
+    REQUIRE(info == destroyed<>);
+}
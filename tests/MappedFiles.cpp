@@ -0,0 +1,143 @@
+#include "OmniMapped.hpp"
+#include "Common.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace DxPtr;
+
+namespace {
+    struct Record {
+        std::uint32_t id;
+        float value;
+    };
+
+    // Removes the file again at the end of the test
+    struct TempFile {
+        std::string path;
+
+        explicit TempFile(const std::vector<Record>& records) {
+            static int counter = 0;
+            path = "omni_mapped_test_" + std::to_string(::getpid()) + "_" + std::to_string(counter++) + ".bin";
+
+            std::ofstream out(path, std::ios::binary);
+            out.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        }
+
+        ~TempFile() {
+            std::remove(path.c_str());
+        }
+
+        std::vector<Record> read() const {
+            std::ifstream in(path, std::ios::binary);
+            std::vector<Record> records(16);
+
+            in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+            records.resize(static_cast<std::size_t>(in.gcount()) / sizeof(Record));
+
+            return records;
+        }
+    };
+
+    std::vector<Record> sample_records() {
+        std::vector<Record> records;
+
+        for (std::uint32_t i = 0; i < 16; i++)
+            records.push_back({ i, i * 1.5f });
+
+        return records;
+    }
+}
+
+TEST_CASE("Mapped file record views", "[mapped][basic]") {
+    TempFile file(sample_records());
+
+    auto mapping = map_file(file.path);
+
+    REQUIRE(mapping.size() == 16 * sizeof(Record));
+
+    omni_view<Record> third = mapping.view<Record>(2 * sizeof(Record));
+    omni_view<Record> last = mapping.view<Record>(15 * sizeof(Record));
+
+    REQUIRE(third->id == 2);
+    REQUIRE(last->value == 22.5f);
+    REQUIRE(reinterpret_cast<const std::byte*>(third.get()) == mapping.get() + 2 * sizeof(Record));
+
+    mapping.advise(map_advice::sequential);
+    mapping.advise(map_advice::will_need, sizeof(Record), sizeof(Record));
+
+    mapping.reset();
+
+    REQUIRE(third.expired());
+    REQUIRE(last.get() == nullptr);
+    REQUIRE(mapping.size() == 0);
+}
+
+TEST_CASE("Mapped file bounds and alignment", "[mapped][errors]") {
+    TempFile file(sample_records());
+
+    auto mapping = map_file(file.path);
+
+    REQUIRE_THROWS_AS(mapping.view<Record>(16 * sizeof(Record)), std::out_of_range);
+    REQUIRE_THROWS_AS(mapping.view<Record>(mapping.size() - 1), std::out_of_range);
+    REQUIRE_THROWS_AS(mapping.view<Record>(1), std::invalid_argument);
+    REQUIRE_THROWS_AS(map_file("omni_mapped_test_missing.bin"), std::system_error);
+}
+
+TEST_CASE("Mapped file write modes", "[mapped][write]") {
+    TempFile file(sample_records());
+
+    SECTION("Copy on write stays private") {
+        auto mapping = map_file(file.path, map_flags::copy_on_write);
+        mapping.ref<Record>(0)->id = 100;
+
+        REQUIRE(mapping.view<Record>(0)->id == 100);
+        REQUIRE(file.read()[0].id == 0);
+    }
+
+    SECTION("Read write reaches the file") {
+        auto mapping = map_file(file.path, map_flags::read_write | map_flags::populate);
+        mapping.ref<Record>(sizeof(Record))->id = 200;
+
+        mapping.reset();
+        REQUIRE(file.read()[1].id == 200);
+    }
+}
+
+TEST_CASE("Mapped file ownership", "[mapped][ownership]") {
+    TempFile file(sample_records());
+
+    auto mapping = map_file(file.path);
+    omni_view<Record> first = mapping.view<Record>(0);
+
+    // Moving keeps the mapping, and plain omni_ptr owners still unmap it
+    omni_mapped_file moved = std::move(mapping);
+    REQUIRE(mapping.size() == 0);
+    REQUIRE(moved.size() == 16 * sizeof(Record));
+
+    // Assigning over a mapping unmaps it
+    auto other = map_file(file.path);
+    omni_view<Record> otherFirst = other.view<Record>(0);
+
+    other = std::move(moved);
+    REQUIRE(otherFirst.expired());
+    REQUIRE(moved.size() == 0);
+    REQUIRE(other.size() == 16 * sizeof(Record));
+
+    moved = std::move(other);
+
+    // Handing the mapping over leaves the file empty, not pointing at nothing
+    omni_ptr<std::byte[]> plain = moved.into_owner();
+    REQUIRE(first->id == 0);
+    REQUIRE(moved.size() == 0);
+    REQUIRE(moved.bytes().empty());
+    REQUIRE(moved == nullptr);
+    REQUIRE_THROWS_AS(moved.view<Record>(0), std::out_of_range);
+
+    plain.reset();
+    REQUIRE(first.expired());
+
+    TempFile empty({});
+    REQUIRE(map_file(empty.path) == nullptr);
+}
@@ -0,0 +1,73 @@
+#include "OmniParallel.hpp"
+#include "Common.hpp"
+
+#include <atomic>
+#include <execution>
+
+using namespace DxPtr;
+
+namespace {
+    std::atomic<int> liveCount = 0;
+    std::atomic<int> constructionsLeft = -1;
+
+    struct Counted {
+        int value = 7;
+
+        Counted() {
+            if (constructionsLeft.fetch_sub(1) == 0)
+                throw std::runtime_error("out of constructions");
+
+            liveCount++;
+        }
+
+        ~Counted() {
+            liveCount--;
+        }
+    };
+}
+
+TEST_CASE("Parallel array construction and destruction", "[parallel][arrays]") {
+    constexpr std::size_t size = 100'000;
+
+    liveCount = 0;
+    constructionsLeft = -1;
+
+    SECTION("Parallel policy") {
+        auto array = make_omni<Counted[]>(std::execution::par, size);
+
+        REQUIRE(liveCount == static_cast<int>(size));
+        REQUIRE(array[0].value == 7);
+        REQUIRE(array[size - 1].value == 7);
+
+        array.reset();
+
+        REQUIRE(liveCount == 0);
+    }
+
+    SECTION("Sequenced policy") {
+        {
+            auto array = make_omni<Counted[]>(std::execution::seq, 1000);
+
+            REQUIRE(liveCount == 1000);
+        }
+
+        REQUIRE(liveCount == 0);
+    }
+
+    SECTION("Trivial types are value-initialized") {
+        auto array = make_omni<int[]>(std::execution::par_unseq, size);
+
+        for (std::size_t i = 0; i < size; i += 997)
+            REQUIRE(array[i] == 0);
+    }
+}
+
+TEST_CASE("Parallel array construction failure", "[parallel][exceptions]") {
+    liveCount = 0;
+    constructionsLeft = 50'000;
+
+    REQUIRE_THROWS_AS(make_omni<Counted[]>(std::execution::par, 100'000), std::runtime_error);
+    REQUIRE(liveCount == 0);
+
+    constructionsLeft = -1;
+}
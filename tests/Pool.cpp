@@ -0,0 +1,135 @@
+#include "OmniPool.hpp"
+#include "Common.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+TEST_CASE("Pool recycles buffers", "[pool][basic]") {
+    TickerInfo info{};
+    omni_pool<Ticker> pool;
+
+    auto first = pool.make(info, "A");
+    const Ticker* address = first.get();
+
+    REQUIRE(first->str == "A");
+    REQUIRE(pool.in_use() == 1);
+    REQUIRE(pool.available() == 0);
+
+    SECTION("Owner reset returns the buffer") {
+        first.reset();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(pool.in_use() == 0);
+        REQUIRE(pool.available() == 1);
+
+        auto second = pool.make(info, "B");
+
+        REQUIRE(second.get() == address);
+        REQUIRE(pool.available() == 0);
+    }
+
+    SECTION("Views keep the buffer until released") {
+        omni_view<Ticker> view = first;
+        first.reset();
+
+        REQUIRE(view.expired());
+        REQUIRE(pool.in_use() == 1);
+        REQUIRE(pool.available() == 0);
+
+        view.reset();
+
+        REQUIRE(pool.in_use() == 0);
+        REQUIRE(pool.available() == 1);
+    }
+}
+
+TEST_CASE("Pool reservation", "[pool][reserve]") {
+    omni_pool<int> pool(16, true);
+
+    REQUIRE(pool.available() == 16);
+
+    std::vector<omni_ptr<int>> owners;
+
+    for (int i = 0; i < 20; i++)
+        owners.push_back(pool.make(i));
+
+    REQUIRE(pool.available() == 0);
+    REQUIRE(pool.in_use() == 20);
+
+    owners.clear();
+
+    REQUIRE(pool.available() == 20);
+
+    pool.reserve(10);
+
+    REQUIRE(pool.available() == 20);
+}
+
+struct ThrowsOnConstruct {
+    ThrowsOnConstruct(bool shouldThrow) {
+        if (shouldThrow)
+            throw std::runtime_error("construct");
+    }
+};
+
+TEST_CASE("Pool construction failure returns the buffer", "[pool][exceptions]") {
+    omni_pool<ThrowsOnConstruct> pool(1);
+
+    REQUIRE_THROWS(pool.make(true));
+    REQUIRE(pool.available() == 1);
+    REQUIRE(pool.in_use() == 0);
+
+    auto ok = pool.make(false);
+
+    REQUIRE(pool.available() == 0);
+}
+
+TEST_CASE("Pool collects returns from other threads", "[pool][threads]") {
+    constexpr int count = 64;
+    omni_pool<int> pool;
+
+    std::vector<omni_ptr<int>> owners;
+    std::vector<omni_view<int>> remoteViews;
+
+    for (int i = 0; i < count; i++)
+        owners.push_back(pool.make(i));
+
+    // Views copied on another thread hold shared rather than biased references
+    std::thread([&] { remoteViews.assign(owners.begin(), owners.end()); }).join();
+
+    owners.clear();
+
+    REQUIRE(pool.in_use() == count);
+
+    // The remote views now hold the last references, so the buffers are released over there
+    std::thread([&] { remoteViews.clear(); }).join();
+
+    REQUIRE(pool.in_use() == 0);
+    REQUIRE(pool.available() == 0);
+
+    auto reused = pool.make(7);
+
+    REQUIRE(pool.available() == count - 1);
+}
+
+TEST_CASE("Pool destroyed before its pointers", "[pool][lifetime]") {
+    TickerInfo info{};
+    omni_view<Ticker> view;
+
+    {
+        omni_ptr<Ticker> owner;
+
+        {
+            omni_pool<Ticker> pool(4);
+            owner = pool.make(info, "A");
+            view = owner;
+        }
+
+        REQUIRE(view->str == "A");
+    }
+
+    REQUIRE(info == destroyed<>);
+    REQUIRE(view.expired());
+}
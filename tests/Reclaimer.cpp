@@ -0,0 +1,61 @@
+#include "OmniReclaimer.hpp"
+#include "Common.hpp"
+
+using namespace DxPtr;
+
+TEST_CASE("Reclaimer destroys on background thread", "[reclaimer][lifetime]") {
+    TickerInfo info{};
+    omni_reclaimer reclaimer;
+
+    auto owner = make_omni<Ticker>(info, "A");
+    omni_view<Ticker> view = owner;
+
+    SECTION("Reset with reclaimer") {
+        owner.reset(reclaimer);
+
+        REQUIRE(not owner);
+        REQUIRE(view.expired());
+        REQUIRE(view.get() == nullptr);
+
+        reclaimer.drain();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(reclaimer.queue_depth() == 0);
+        REQUIRE(reclaimer.reclaimed_count() == 1);
+        REQUIRE(view.use_count() == 1);
+    }
+
+    SECTION("Retire moved owner") {
+        reclaimer.retire(std::move(owner));
+
+        REQUIRE(view.expired());
+
+        reclaimer.drain();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(reclaimer.max_lag() >= reclaimer.last_lag());
+    }
+
+    SECTION("Empty owner is a no-op") {
+        omni_ptr<Ticker> empty;
+        empty.reset(reclaimer);
+        reclaimer.drain();
+
+        REQUIRE(reclaimer.reclaimed_count() == 0);
+    }
+}
+
+TEST_CASE("Reclaimer drains on destruction", "[reclaimer][lifetime]") {
+    ArrayTicker::Reset();
+
+    {
+        omni_reclaimer reclaimer;
+
+        for (int i = 0; i < 100; i++) {
+            auto owner = make_omni<ArrayTicker[]>(10);
+            owner.reset(reclaimer);
+        }
+    }
+
+    REQUIRE(ArrayTicker::info == destroyed<1000>);
+}
@@ -0,0 +1,143 @@
+#include "OmniRegion.hpp"
+#include "Common.hpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+TEST_CASE("Region basic use", "[region][basic]") {
+    TickerInfo info{};
+    omni_region region(1024);
+
+    auto a = region.make<Ticker>(info, "A");
+    auto b = region.make<Ticker>(info, "B");
+    omni_view<Ticker> viewA = a;
+
+    REQUIRE(a->str == "A");
+    REQUIRE(b->str == "B");
+    REQUIRE(region.object_count() == 2);
+    REQUIRE(a.use_count() == 2);
+
+    SECTION("Owners destroy early") {
+        a.reset();
+
+        REQUIRE(info == TickerInfo{ .constructed = 2, .destroyed = 1 });
+        REQUIRE(viewA.expired());
+
+        region.end();
+
+        REQUIRE(info == destroyed<2>);
+    }
+
+    SECTION("Ending the region expires every view") {
+        region.end();
+
+        REQUIRE(info == destroyed<2>);
+        REQUIRE(viewA.expired());
+        REQUIRE(viewA.get() == nullptr);
+
+        // Owners outliving the region may still be reset without destroying anything twice
+        a.reset();
+        b.reset();
+
+        REQUIRE(info == destroyed<2>);
+        REQUIRE(viewA.expired());
+    }
+}
+
+TEST_CASE("Region views outlive the region", "[region][lifetime]") {
+    TickerInfo info{};
+    std::vector<omni_view<Ticker>> views;
+
+    {
+        omni_region region(256);
+
+        for (int i = 0; i < 1000; i++)
+            views.push_back(region.make<Ticker>(info, std::to_string(i)));
+
+        REQUIRE(info.constructed == 1000);
+    }
+
+    for (auto& view : views)
+        REQUIRE(view.expired());
+
+    REQUIRE(info == destroyed<1000>);
+}
+
+TEST_CASE("Region handles alignment and oversized objects", "[region][alignment]") {
+    struct alignas(64) Aligned {
+        int value;
+    };
+
+    struct Big {
+        std::byte bytes[4096];
+    };
+
+    omni_region region(512);
+
+    auto small = region.make<int>(1);
+    auto aligned = region.make<Aligned>(Aligned{ 2 });
+    auto big = region.make<Big>();
+    auto after = region.make<int>(3);
+
+    REQUIRE(reinterpret_cast<std::uintptr_t>(aligned.get()) % 64 == 0);
+    REQUIRE(aligned->value == 2);
+    REQUIRE(*small == 1);
+    REQUIRE(*after == 3);
+    REQUIRE(region.bytes_reserved() >= 4096 + 512);
+
+    region.end();
+
+    REQUIRE(region.bytes_reserved() == 0);
+
+    auto reused = region.make<int>(4);
+
+    REQUIRE(*reused == 4);
+    REQUIRE(region.object_count() == 1);
+}
+
+TEST_CASE("Region views released on other threads", "[region][threads]") {
+    std::vector<omni_view<int>> views;
+
+    {
+        omni_region region;
+
+        for (int i = 0; i < 100; i++)
+            views.push_back(region.make<int>(i));
+    }
+
+    std::thread([&] { views.clear(); }).join();
+
+    REQUIRE(views.empty());
+}
+
+TEST_CASE("Region owners reset while the region ends", "[region][threads]") {
+    struct Counted {
+        std::atomic<int>* destroyed;
+        ~Counted() { destroyed->fetch_add(1); }
+    };
+
+    constexpr int count = 1000;
+
+    for (int round = 0; round < 20; round++) {
+        std::atomic<int> destroyed = 0;
+        omni_region region;
+        std::vector<omni_ptr<Counted>> owners;
+
+        for (int i = 0; i < count; i++)
+            owners.push_back(region.make<Counted>(&destroyed));
+
+        // Each object is destroyed once, by whichever side claims it first
+        std::thread resetter([&] {
+            for (auto& owner : owners)
+                owner.reset();
+        });
+
+        region.end();
+        resetter.join();
+
+        REQUIRE(destroyed == count);
+    }
+}
@@ -0,0 +1,204 @@
+#include "OmniRegistry.hpp"
+#include "OmniBudget.hpp"
+#include "Common.hpp"
+
+#include <atomic>
+#include <latch>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+namespace {
+    struct Session {
+        std::string user;
+        std::atomic<int> hits = 0;
+
+        explicit Session(std::string user) : user(std::move(user)) { }
+    };
+}
+
+TEST_CASE("Registry basic use", "[registry][basic]") {
+    omni_registry<int, Session> sessions;
+
+    auto [alice, made] = sessions.try_emplace(1, "alice");
+    REQUIRE(made);
+    REQUIRE(alice->user == "alice");
+
+    auto [again, remade] = sessions.try_emplace(1, "mallory");
+    REQUIRE(not remade);
+    REQUIRE(again->user == "alice");
+
+    auto bob = make_omni<Session>("bob");
+    REQUIRE(sessions.insert(2, std::move(bob)).second);
+    REQUIRE(bob == nullptr);
+
+    auto eve = make_omni<Session>("eve");
+    REQUIRE(not sessions.insert(2, std::move(eve)).second);
+    REQUIRE(eve->user == "eve");
+
+    REQUIRE(sessions.size() == 2);
+    REQUIRE(sessions.contains(2));
+    REQUIRE(sessions.view(2)->user == "bob");
+    REQUIRE(sessions.ref(3) == nullptr);
+    REQUIRE(sessions.view(3) == nullptr);
+
+    REQUIRE(sessions.visit(1, [](Session& session) { session.hits++; }));
+    REQUIRE(not sessions.visit(3, [](Session&) { }));
+    REQUIRE(alice->hits == 1);
+
+    // Erasing expires every handle given out
+    omni_view<Session> aliceView = sessions.view(1);
+    REQUIRE(sessions.erase(1));
+    REQUIRE(not sessions.erase(1));
+    REQUIRE(alice.expired());
+    REQUIRE(aliceView.expired());
+
+    omni_view<Session> oldBob = sessions.view(2);
+    sessions.insert_or_assign(2, make_omni<Session>("robert"));
+    REQUIRE(oldBob.expired());
+    REQUIRE(sessions.view(2)->user == "robert");
+
+    // Extracting hands ownership back without expiring
+    omni_ptr<Session> robert = sessions.extract(2);
+    REQUIRE(robert->user == "robert");
+    REQUIRE(sessions.extract(2) == nullptr);
+    REQUIRE(sessions.empty());
+
+    REQUIRE_THROWS_AS(sessions.insert(5, omni_ptr<Session>()), std::invalid_argument);
+}
+
+TEST_CASE("Registry replaces named owners", "[registry][basic]") {
+    TickerInfo info;
+    omni_registry<int, Ticker> tickers;
+
+    tickers.try_emplace(1, info, "old");
+    omni_view<Ticker> oldView = tickers.view(1);
+
+    auto replacement = make_omni<Ticker>(info, "new");
+    tickers.insert_or_assign(1, std::move(replacement));
+
+    // The old object is destroyed, not handed back through the moved-from owner
+    REQUIRE(oldView.expired());
+    REQUIRE(info.destroyed == 1);
+    REQUIRE(replacement == nullptr);
+    REQUIRE(tickers.view(1)->str == "new");
+
+    tickers.clear();
+    REQUIRE(info.destroyed == 2);
+}
+
+TEST_CASE("Registry adopts owners made on other threads", "[registry][threads]") {
+    TickerInfo info;
+    omni_budget budget;
+    omni_registry<int, Ticker> tickers;
+
+    omni_ptr<Ticker> owner;
+    omni_view<Ticker> view;
+    std::latch made(1);
+    std::latch checked(1);
+
+    // The creator stays alive and idle, so only insertion can take the bias away from it
+    std::thread creator([&] {
+        owner = budget.make<Ticker>(info, "A");
+        view = owner;
+        made.count_down();
+        checked.wait();
+    });
+
+    made.wait();
+
+    REQUIRE(tickers.insert(1, std::move(owner)).second);
+    REQUIRE(tickers.view(1).use_count() == 3);
+
+    std::thread([moved = std::move(view)]() mutable {
+        moved.reset();
+    }).join();
+
+    REQUIRE(tickers.erase(1));
+    REQUIRE(info == destroyed<>);
+    REQUIRE(budget.live_bytes() == 0);
+
+    checked.count_down();
+    creator.join();
+}
+
+TEST_CASE("Registry shards", "[registry][shards]") {
+    omni_registry<int, int> single(1);
+    omni_registry<int, int> odd(5);
+
+    REQUIRE(single.shard_count() == 1);
+    REQUIRE(odd.shard_count() == 8);
+
+    for (int i = 0; i < 100; i++)
+        odd.try_emplace(i, i * 2);
+
+    int total = 0;
+    odd.for_each([&](const int& key, int& value) {
+        REQUIRE(value == key * 2);
+        total += value;
+    });
+
+    REQUIRE(total == 9900);
+
+    omni_view<int> first = odd.view(0);
+    odd.clear();
+
+    REQUIRE(odd.empty());
+    REQUIRE(first.expired());
+}
+
+TEST_CASE("Registry concurrent use", "[registry][threads]") {
+    constexpr int key_count = 64;
+    constexpr int rounds = 2000;
+
+    omni_registry<int, Session> sessions(4);
+
+    for (int i = 0; i < key_count; i++)
+        sessions.try_emplace(i, "user" + std::to_string(i));
+
+    std::atomic<bool> go = false;
+    std::atomic<int> seen = 0;
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, t] {
+            while (not go.load()) { }
+
+            for (int round = 0; round < rounds; round++) {
+                int key = (round * 7 + t) % key_count;
+
+                if (sessions.visit(key, [](Session& session) { session.hits++; }))
+                    seen++;
+
+                // Views made here see the erase on the other thread as expiry
+                omni_view<Session> view = sessions.view(key);
+
+                if (view != nullptr)
+                    seen++;
+            }
+        });
+    }
+
+    threads.emplace_back([&] {
+        while (not go.load()) { }
+
+        for (int round = 0; round < rounds; round++) {
+            int key = round % key_count;
+
+            if (round % 2 == 0)
+                sessions.erase(key);
+            else
+                sessions.try_emplace(key, "user" + std::to_string(key));
+        }
+    });
+
+    go = true;
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(seen > 0);
+    REQUIRE(sessions.size() <= key_count);
+}
@@ -0,0 +1,194 @@
+#include "OmniVector.hpp"
+#include "Common.hpp"
+
+#include <stdexcept>
+
+using namespace DxPtr;
+
+static_assert(is_trivially_relocatable_v<omni_ptr<Ticker>>);
+static_assert(is_trivially_relocatable_v<omni_view<Ticker>>);
+static_assert(is_trivially_relocatable_v<omni_ref<const Ticker>>);
+static_assert(is_trivially_relocatable_v<int>);
+static_assert(not is_trivially_relocatable_v<Ticker>);
+static_assert(detail::is_reallocatable<omni_ptr<int>>);
+
+TEST_CASE("Relocating omni pointers", "[relocate][basic]") {
+    TickerInfo info{};
+
+    auto owner = make_omni<Ticker>(info, "A");
+    omni_view<Ticker> view = owner;
+
+    alignas(omni_ptr<Ticker>) std::byte storage[sizeof(omni_ptr<Ticker>)];
+    auto* moved = omni_relocate(&owner, reinterpret_cast<omni_ptr<Ticker>*>(storage));
+
+    // Neither the move constructor nor the destructor ran, so the count is unchanged
+    REQUIRE(moved->use_count() == 2);
+    REQUIRE(view == *moved);
+    REQUIRE(info == TickerInfo{ .constructed = 1 });
+
+    // Relocate back so the original object is alive again for its destructor
+    omni_relocate(moved, &owner);
+
+    REQUIRE(owner.use_count() == 2);
+
+    owner.reset();
+
+    REQUIRE(info == destroyed<>);
+    REQUIRE(view.expired());
+}
+
+using owner_vector = omni_vector<omni_ptr<Ticker>>;
+using small_owner_vector = omni_small_vector<omni_ptr<Ticker>, 4>;
+
+TEMPLATE_TEST_CASE("Relocation-aware vectors", "[relocate][vector]", owner_vector, small_owner_vector) {
+    using vector_t = TestType;
+    TickerInfo info{};
+
+    std::vector<omni_view<Ticker>> views;
+
+    {
+        vector_t owners;
+
+        for (int i = 0; i < 100; i++) {
+            owners.push_back(make_omni<Ticker>(info, std::to_string(i)));
+            views.push_back(owners.back());
+        }
+
+        REQUIRE(owners.size() == 100);
+        REQUIRE(owners.capacity() >= 100);
+        REQUIRE(info.constructed == 100);
+        REQUIRE(info.destroyed == 0);
+
+        for (int i = 0; i < 100; i++) {
+            REQUIRE(owners[i]->str == std::to_string(i));
+            REQUIRE(owners[i].use_count() == 2);
+            REQUIRE(views[i] == owners[i]);
+        }
+
+        SECTION("Erase shifts the tail") {
+            owners.erase(owners.begin() + 10);
+
+            REQUIRE(owners.size() == 99);
+            REQUIRE(views[10].expired());
+            REQUIRE(owners[10]->str == "11");
+            REQUIRE(owners[10].use_count() == 2);
+        }
+
+        SECTION("Move keeps the elements") {
+            vector_t moved = std::move(owners);
+
+            REQUIRE(owners.empty());
+            REQUIRE(moved.size() == 100);
+            REQUIRE(moved[99].use_count() == 2);
+        }
+
+        SECTION("Emplace from an element of the same vector") {
+            owners.resize(owners.capacity());
+            owners.back() = make_omni<Ticker>(info, "last");
+
+            omni_view<Ticker> last = owners.back();
+            owners.emplace_back(std::move(owners.back()));
+
+            REQUIRE(owners.back() == last);
+            REQUIRE(owners[owners.size() - 2] == nullptr);
+        }
+    }
+
+    for (auto& view : views)
+        REQUIRE(view.expired());
+
+    REQUIRE(info.constructed == info.destroyed);
+    REQUIRE(info.moveConstructed == 0);
+}
+
+TEST_CASE("Small vector stays inline", "[relocate][vector]") {
+    omni_small_vector<omni_ptr<int>, 4> small;
+
+    for (int i = 0; i < 4; i++)
+        small.emplace_back(make_omni<int>(i));
+
+    const omni_ptr<int>* inlineData = small.data();
+    REQUIRE(reinterpret_cast<const std::byte*>(inlineData) >= reinterpret_cast<const std::byte*>(&small));
+    REQUIRE(reinterpret_cast<const std::byte*>(inlineData) < reinterpret_cast<const std::byte*>(&small + 1));
+
+    omni_small_vector<omni_ptr<int>, 4> moved = std::move(small);
+
+    REQUIRE(small.empty());
+    REQUIRE(moved.size() == 4);
+    REQUIRE(*moved[3] == 3);
+
+    moved.emplace_back(make_omni<int>(4));
+
+    REQUIRE(moved.capacity() > 4);
+    REQUIRE(*moved[4] == 4);
+}
+
+TEST_CASE("Vectors of non-relocatable types", "[relocate][vector]") {
+    TickerInfo info{};
+
+    {
+        omni_vector<Ticker> tickers;
+
+        for (int i = 0; i < 20; i++)
+            tickers.emplace_back(info, std::to_string(i));
+
+        REQUIRE(tickers.size() == 20);
+        REQUIRE(tickers[19].str == "19");
+        REQUIRE(info.moveConstructed > 0);
+
+        omni_vector<Ticker> copy = tickers;
+
+        REQUIRE(copy.size() == 20);
+        REQUIRE(copy[5].str == "5");
+    }
+
+    REQUIRE(info.constructed + info.copyConstructed + info.moveConstructed == info.destroyed);
+}
+
+struct ThrowingMove {
+    inline static int live = 0;
+    inline static int movesLeft = -1;
+
+    int value;
+
+    ThrowingMove(int value) : value(value) { live++; }
+
+    ThrowingMove(const ThrowingMove& copy) : value(copy.value) { live++; }
+
+    ThrowingMove(ThrowingMove&& move) : value(move.value) {
+        if (movesLeft-- == 0)
+            throw std::runtime_error("move");
+
+        live++;
+    }
+
+    ~ThrowingMove() { live--; }
+};
+
+TEST_CASE("Erase with a throwing move", "[relocate][vector]") {
+    ThrowingMove::live = 0;
+
+    {
+        omni_vector<ThrowingMove> values;
+        values.reserve(6);
+
+        for (int i = 0; i < 6; i++)
+            values.emplace_back(i);
+
+        // Erasing the second element shifts four, the third of those throws
+        ThrowingMove::movesLeft = 2;
+
+        REQUIRE_THROWS_AS(values.erase(values.begin() + 1), std::runtime_error);
+
+        ThrowingMove::movesLeft = -1;
+
+        // The first element and the two shifted ones are left
+        REQUIRE(values.size() == 3);
+        REQUIRE(ThrowingMove::live == 3);
+        REQUIRE(values[0].value == 0);
+        REQUIRE(values[1].value == 2);
+        REQUIRE(values[2].value == 3);
+    }
+
+    REQUIRE(ThrowingMove::live == 0);
+}
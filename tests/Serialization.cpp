@@ -0,0 +1,195 @@
+#include "OmniGraph.hpp"
+#include "Common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace DxPtr;
+
+namespace {
+    struct Scene {
+        int id = 0;
+        double weight = 0;
+        std::string name;
+
+        std::vector<omni_ptr<Scene>> children;
+        omni_ref<Scene> link;
+        omni_view<Scene> parent;
+
+        template<typename Archive>
+        void visit(Archive& archive) {
+            archive(id, weight, name, children, link, parent);
+        }
+    };
+
+    omni_ptr<Scene> make_scene(int id, std::string name) {
+        auto scene = make_omni<Scene>();
+        scene->id = id;
+        scene->weight = id * 0.5;
+        scene->name = std::move(name);
+
+        return scene;
+    }
+
+    omni_ref<Scene> add_child(omni_ptr<Scene>& parent, int id, std::string name) {
+        auto& child = parent->children.emplace_back(make_scene(id, std::move(name)));
+        child->parent = parent;
+
+        return child;
+    }
+}
+
+TEST_CASE("Graph round trip", "[graph][basic]") {
+    auto root = make_scene(0, "root");
+    auto left = add_child(root, 1, "left");
+    auto right = add_child(root, 2, "right");
+
+    auto& leftOwner = root->children[0];
+    add_child(leftOwner, 3, "leaf");
+
+    left->link = right;
+    right->link = left;
+    root->link = leftOwner->children[0];
+
+    auto image = save_omni_graph(root);
+    auto graph = load_omni_graph<Scene>(image);
+
+    REQUIRE(graph.node_count() == 4);
+    REQUIRE(graph->name == "root");
+    REQUIRE(graph->children.size() == 2);
+    REQUIRE(graph->parent == nullptr);
+
+    Scene& newLeft = *graph->children[0];
+    Scene& newRight = *graph->children[1];
+
+    REQUIRE(newLeft.name == "left");
+    REQUIRE(newRight.weight == 1.0);
+    REQUIRE(newLeft.children[0]->name == "leaf");
+
+    // Links point into the new graph, not the old one
+    REQUIRE(newLeft.link.get() == &newRight);
+    REQUIRE(newRight.link.get() == &newLeft);
+    REQUIRE(graph->link.get() == newLeft.children[0].get());
+    REQUIRE(newLeft.parent.get() == graph.get());
+    REQUIRE(newLeft.children[0]->parent.get() == &newLeft);
+
+    // Saving the loaded graph gives the same image
+    REQUIRE(save_omni_graph(graph.root()) == image);
+
+    omni_view<Scene> leftView = graph->children[0];
+
+    graph = omni_graph<Scene>();
+    REQUIRE(leftView.expired());
+}
+
+TEST_CASE("Graph nodes load into one arena", "[graph][arena]") {
+    auto root = make_scene(0, "root");
+    omni_ptr<Scene>* tail = &root;
+
+    for (int i = 1; i < 1000; i++) {
+        add_child(*tail, i, "");
+        tail = &(*tail)->children[0];
+    }
+
+    auto graph = load_omni_graph<Scene>(save_omni_graph(root));
+
+    REQUIRE(graph.node_count() == 1000);
+
+    std::vector<const Scene*> addresses;
+
+    for (const Scene* node = graph.get(); node != nullptr; node = node->children.empty() ? nullptr : node->children[0].get())
+        addresses.push_back(node);
+
+    REQUIRE(addresses.size() == 1000);
+
+    auto [lowest, highest] = std::minmax_element(addresses.begin(), addresses.end());
+    REQUIRE(static_cast<std::size_t>(*highest - *lowest) < addresses.size());
+}
+
+TEST_CASE("Graph move assignment", "[graph][basic]") {
+    auto root = make_scene(0, "first");
+    add_child(root, 1, "child");
+
+    auto graph = load_omni_graph<Scene>(save_omni_graph(root));
+    omni_view<Scene> oldChild = graph->children[0];
+
+    root->name = "second";
+    auto next = load_omni_graph<Scene>(save_omni_graph(root));
+    omni_view<Scene> newChild = next->children[0];
+
+    // The old graph is torn down before the new one moves in
+    graph = std::move(next);
+
+    REQUIRE(oldChild.expired());
+    REQUIRE_FALSE(newChild.expired());
+    REQUIRE(graph->name == "second");
+    REQUIRE(graph.node_count() == 2);
+    REQUIRE(next.get() == nullptr);
+    REQUIRE(next.node_count() == 0);
+}
+
+TEST_CASE("Graph expired and foreign views", "[graph][views]") {
+    auto root = make_scene(0, "root");
+
+    {
+        auto stranger = make_scene(9, "stranger");
+        root->link = stranger;
+    }
+
+    // Expired views are saved as null
+    auto graph = load_omni_graph<Scene>(save_omni_graph(root));
+    REQUIRE(graph->link == nullptr);
+
+    auto stranger = make_scene(9, "stranger");
+    root->link = stranger;
+
+    REQUIRE_THROWS_AS(save_omni_graph(root), std::runtime_error);
+}
+
+TEST_CASE("Graph rejects corrupt images", "[graph][errors]") {
+    auto root = make_scene(0, "root");
+    add_child(root, 1, "child");
+
+    auto image = save_omni_graph(root);
+
+    SECTION("Truncated") {
+        image.pop_back();
+        REQUIRE_THROWS_AS(load_omni_graph<Scene>(image), std::runtime_error);
+    }
+
+    SECTION("Bad magic") {
+        image[0] = std::byte{ 0 };
+        REQUIRE_THROWS_AS(load_omni_graph<Scene>(image), std::runtime_error);
+    }
+
+    SECTION("Owned twice") {
+        // The root's only child edge is the first u64 after its name and child count
+        std::size_t childEdge = sizeof(detail::graph_header) + sizeof(int) + sizeof(double) + 8 + 4 + 8;
+        std::uint64_t edge = 1;
+
+        std::memcpy(image.data() + childEdge, &edge, sizeof(edge));
+        REQUIRE_THROWS_AS(load_omni_graph<Scene>(image), std::runtime_error);
+    }
+
+    SECTION("Empty") {
+        REQUIRE_THROWS_AS(load_omni_graph<Scene>(std::span<const std::byte>()), std::runtime_error);
+    }
+}
+
+TEST_CASE("Graph files", "[graph][files]") {
+    auto root = make_scene(0, "root");
+    auto child = add_child(root, 1, "child");
+    child->link = child;
+
+    std::string path = "omni_graph_test_" + std::to_string(::getpid()) + ".bin";
+
+    save_omni_graph(root, path);
+    auto graph = load_omni_graph<Scene>(path);
+
+    std::remove(path.c_str());
+
+    REQUIRE(graph->children[0]->name == "child");
+    REQUIRE(graph->children[0]->link.get() == graph->children[0].get());
+
+    REQUIRE_THROWS_AS(load_omni_graph<Scene>(path), std::system_error);
+}
@@ -0,0 +1,204 @@
+#include "OmniShm.hpp"
+#include "Common.hpp"
+
+#include <sys/wait.h>
+
+using namespace DxPtr;
+
+namespace {
+    std::string unique_segment_name() {
+        static int counter = 0;
+        return "/omni_test_" + std::to_string(::getpid()) + "_" + std::to_string(counter++);
+    }
+
+    struct Quote {
+        int id;
+        double price;
+        char symbol[8];
+    };
+
+    // Published by the producer for consumers to find
+    struct Directory {
+        omni_shm_handle<Quote> latest;
+    };
+}
+
+TEST_CASE("Shared memory basic use", "[shm][basic]") {
+    auto segment = omni_shm_segment::create(unique_segment_name(), 64 * 1024);
+
+    auto quote = segment.make<Quote>(Quote{ 1, 101.5, "ACME" });
+    omni_shm_view<Quote> view = quote;
+
+    REQUIRE(quote->id == 1);
+    REQUIRE(view->price == 101.5);
+    REQUIRE(not view.expired());
+
+    quote.reset();
+
+    REQUIRE(view.expired());
+    REQUIRE(view.get() == nullptr);
+}
+
+TEST_CASE("Shared memory views through another mapping", "[shm][mapping]") {
+    std::string name = unique_segment_name();
+
+    auto producer = omni_shm_segment::create(name, 64 * 1024);
+    auto consumer = omni_shm_segment::open(name);
+
+    auto directory = producer.make<Directory>();
+    auto quote = producer.make<Quote>(Quote{ 2, 42.0, "XYZ" });
+
+    directory->latest = quote.handle();
+
+    // The consumer only knows where the directory is, and finds the quote through it
+    omni_shm_view<Directory> directoryView(consumer, directory.handle());
+    omni_shm_view<Quote> quoteView(consumer, directoryView->latest);
+
+    REQUIRE(quoteView.get() != quote.get());
+    REQUIRE(quoteView->id == 2);
+    REQUIRE(std::string(quoteView->symbol) == "XYZ");
+
+    quote->price = 43.0;
+    REQUIRE(quoteView->price == 43.0);
+
+    quote.reset();
+    REQUIRE(quoteView.expired());
+
+    // A slot reused for a new object does not revive old views
+    auto replacement = producer.make<Quote>(Quote{ 3, 1.0, "NEW" });
+
+    REQUIRE(replacement.handle().offset == directoryView->latest.offset);
+    REQUIRE(quoteView.expired());
+    REQUIRE(omni_shm_view<Quote>(consumer, replacement.handle())->id == 3);
+}
+
+TEST_CASE("Shared memory views reject foreign handles", "[shm][errors]") {
+    auto segment = omni_shm_segment::create(unique_segment_name(), 4096);
+    auto quote = segment.make<Quote>(Quote{ 5, 2.0, "OK" });
+
+    omni_shm_handle<Quote> handle = quote.handle();
+
+    REQUIRE(omni_shm_view<Quote>(segment, handle)->id == 5);
+
+    SECTION("Past the end of the segment") {
+        handle.offset = segment.size();
+        REQUIRE_THROWS_AS(omni_shm_view<Quote>(segment, handle), std::system_error);
+
+        handle.offset = std::uint64_t(1) << 39;
+        REQUIRE_THROWS_AS(omni_shm_view<Quote>(segment, handle), std::system_error);
+    }
+
+    SECTION("Block straddling the end of the segment") {
+        handle.offset = segment.size() - detail::shm_slot_alignment;
+        REQUIRE_THROWS_AS(omni_shm_view<Quote>(segment, handle), std::system_error);
+    }
+
+    SECTION("Misaligned") {
+        handle.offset += 8;
+        REQUIRE_THROWS_AS(omni_shm_view<Quote>(segment, handle), std::system_error);
+    }
+
+    SECTION("Inside the segment header") {
+        handle.offset = detail::shm_slot_alignment / 2;
+        REQUIRE_THROWS_AS(omni_shm_view<Quote>(segment, handle), std::system_error);
+    }
+
+    SECTION("Slot of another size") {
+        struct Wide {
+            char bytes[512];
+        };
+
+        // Inside the segment and aligned, but reading a Wide would run into the next slot
+        omni_shm_handle<Wide> wide{ handle.offset, handle.stamp };
+        REQUIRE_THROWS_AS(omni_shm_view<Wide>(segment, wide), std::system_error);
+    }
+
+    SECTION("Empty handles are still fine") {
+        REQUIRE(omni_shm_view<Quote>(segment, omni_shm_handle<Quote>{}).expired());
+    }
+}
+
+namespace {
+    // Standard layout, but copying it runs code of this process
+    struct Tracked {
+        int id = 0;
+
+        Tracked() = default;
+        Tracked(const Tracked& copy) : id(copy.id) { }
+    };
+
+    template<typename T>
+    concept storable_in_shm = requires(omni_shm_segment& segment) { segment.make<T>(); };
+}
+
+static_assert(storable_in_shm<Quote>);
+static_assert(std::is_standard_layout_v<Tracked> and not storable_in_shm<Tracked>);
+
+TEST_CASE("Shared memory segment exhaustion", "[shm][errors]") {
+    auto segment = omni_shm_segment::create(unique_segment_name(), 4096);
+
+    std::vector<omni_shm_ptr<Quote>> quotes;
+
+    REQUIRE_THROWS_AS([&]() {
+        while (true)
+            quotes.push_back(segment.make<Quote>());
+    }(), std::bad_alloc);
+
+    REQUIRE(not quotes.empty());
+
+    // Freed slots are handed out again
+    std::size_t used = segment.bytes_used();
+
+    quotes.pop_back();
+    quotes.push_back(segment.make<Quote>());
+
+    REQUIRE(segment.bytes_used() == used);
+    REQUIRE_THROWS_AS(omni_shm_segment::open("/omni_test_missing"), std::system_error);
+}
+
+TEST_CASE("Shared memory views in another process", "[shm][process]") {
+    std::string name = unique_segment_name();
+
+    auto segment = omni_shm_segment::create(name, 64 * 1024);
+    auto directory = segment.make<Directory>();
+    auto quote = segment.make<Quote>(Quote{ 4, 7.0, "FORK" });
+
+    directory->latest = quote.handle();
+
+    int ready[2], done[2];
+    REQUIRE(::pipe(ready) == 0);
+    REQUIRE(::pipe(done) == 0);
+
+    pid_t child = ::fork();
+    REQUIRE(child != -1);
+
+    if (child == 0) {
+        // Exit codes report which check failed
+        auto mapping = omni_shm_segment::open(name);
+        omni_shm_view<Directory> directoryView(mapping, directory.handle());
+        omni_shm_view<Quote> view(mapping, directoryView->latest);
+
+        if (view.expired() or view->id != 4)
+            ::_exit(1);
+
+        char byte = 0;
+        (void) ::write(ready[1], &byte, 1);
+        (void) ::read(done[0], &byte, 1);
+
+        ::_exit(view.expired() ? 0 : 2);
+    }
+
+    char byte = 0;
+    REQUIRE(::read(ready[0], &byte, 1) == 1);
+
+    quote.reset();
+    REQUIRE(::write(done[1], &byte, 1) == 1);
+
+    int status = 0;
+    REQUIRE(::waitpid(child, &status, 0) == child);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+
+    for (int fd : { ready[0], ready[1], done[0], done[1] })
+        ::close(fd);
+}
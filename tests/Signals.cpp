@@ -0,0 +1,198 @@
+#include "OmniSignal.hpp"
+#include "Common.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace DxPtr;
+
+namespace {
+    struct Listener {
+        int total = 0;
+        std::vector<std::string> names;
+
+        void add(int value) {
+            total += value;
+        }
+
+        void named(int, const std::string& name) {
+            names.push_back(name);
+        }
+    };
+
+    struct Counter {
+        static inline int reads = 0;
+
+        int value = 0;
+
+        void read() const {
+            reads += value;
+        }
+    };
+}
+
+TEST_CASE("Signal basic use", "[signal][basic]") {
+    omni_signal<int> changed;
+
+    auto first = make_omni<Listener>();
+    auto second = make_omni<Listener>();
+
+    changed.connect<&Listener::add>(omni_ref<Listener>(first));
+    changed.connect<&Listener::add>(omni_ref<Listener>(second));
+    changed.connect(omni_ref<Listener>(second), [](Listener& listener, int& value) { listener.total += value * 100; });
+
+    changed.emit(2);
+    changed(3);
+
+    REQUIRE(first->total == 5);
+    REQUIRE(second->total == 505);
+    REQUIRE(changed.size() == 3);
+
+    // Slots hold the receiver's block, not the receiver
+    REQUIRE(first.use_count() == 2);
+
+    REQUIRE(changed.disconnect(second) == 2);
+    REQUIRE(changed.size() == 1);
+
+    changed.emit(1);
+    REQUIRE(first->total == 6);
+    REQUIRE(second->total == 505);
+
+    REQUIRE_THROWS_AS(changed.connect<&Listener::add>(omni_ref<Listener>()), std::invalid_argument);
+}
+
+TEST_CASE("Signal const receivers and reference arguments", "[signal][basic]") {
+    Counter::reads = 0;
+
+    auto counter = make_omni<Counter>(Counter{ 7 });
+    omni_signal<> tick;
+    tick.connect<&Counter::read>(omni_view<Counter>(counter));
+
+    tick.emit();
+    tick.emit();
+    REQUIRE(Counter::reads == 14);
+
+    auto listener = make_omni<Listener>();
+    omni_signal<int, const std::string&> renamed;
+    renamed.connect<&Listener::named>(omni_ref<Listener>(listener));
+
+    std::string name = "omni";
+    renamed.emit(0, name);
+
+    REQUIRE(listener->names == std::vector<std::string>{ "omni" });
+}
+
+TEST_CASE("Signal receivers disconnect by expiring", "[signal][expiry]") {
+    omni_signal<int> changed;
+    std::vector<omni_ptr<Listener>> listeners;
+
+    for (int i = 0; i < 64; i++) {
+        listeners.push_back(make_omni<Listener>());
+        changed.connect<&Listener::add>(omni_ref<Listener>(listeners.back()));
+    }
+
+    for (std::size_t i = 0; i < listeners.size(); i += 2)
+        listeners[i].reset();
+
+    REQUIRE(changed.size() == 64);
+
+    changed.emit(1);
+
+    REQUIRE(changed.size() == 32);
+
+    for (std::size_t i = 1; i < listeners.size(); i += 2)
+        REQUIRE(listeners[i]->total == 1);
+
+    listeners[1].reset();
+    REQUIRE(changed.compact() == 1);
+    REQUIRE(changed.size() == 31);
+
+    changed.clear();
+    REQUIRE(changed.empty());
+    REQUIRE(listeners[3].use_count() == 1);
+}
+
+TEST_CASE("Signal reentrancy", "[signal][reentrant]") {
+    struct Node {
+        omni_signal<int>* signal;
+        omni_ptr<Node>* other;
+        int calls = 0;
+
+        void fire(int depth) {
+            calls++;
+
+            if (depth > 0)
+                signal->emit(depth - 1);
+        }
+
+        void drop(int) {
+            calls++;
+            other->reset();
+        }
+    };
+
+    omni_signal<int> changed;
+    omni_ptr<Node> dropped;
+
+    auto dropper = make_omni<Node>(Node{ &changed, &dropped });
+    auto firer = make_omni<Node>(Node{ &changed, nullptr });
+    dropped = make_omni<Node>(Node{ &changed, nullptr });
+
+    changed.connect<&Node::drop>(omni_ref<Node>(dropper));
+    changed.connect<&Node::fire>(omni_ref<Node>(firer));
+    changed.connect<&Node::fire>(omni_ref<Node>(dropped));
+
+    // Nested emissions skip the receiver destroyed by the first slot without moving anything
+    changed.emit(2);
+
+    REQUIRE(dropper->calls == 3);
+    REQUIRE(firer->calls == 3);
+    REQUIRE(changed.size() == 2);
+
+    // Connecting from inside a slot takes effect at the next emission
+    struct Connector {
+        omni_signal<int>* signal;
+        omni_ptr<Listener>* late;
+
+        void connect_late(int) {
+            signal->connect<&Listener::add>(omni_ref<Listener>(*late));
+        }
+    };
+
+    auto late = make_omni<Listener>();
+    auto connector = make_omni<Connector>(Connector{ &changed, &late });
+
+    changed.clear();
+    changed.connect<&Connector::connect_late>(omni_ref<Connector>(connector));
+
+    changed.emit(5);
+    REQUIRE(late->total == 0);
+    REQUIRE(changed.size() == 2);
+
+    changed.emit(5);
+    REQUIRE(late->total == 5);
+}
+
+TEST_CASE("Signal exceptions", "[signal][errors]") {
+    omni_signal<int> changed;
+
+    auto expired = make_omni<Listener>();
+    auto thrower = make_omni<Listener>();
+    auto after = make_omni<Listener>();
+
+    changed.connect<&Listener::add>(omni_ref<Listener>(expired));
+    changed.connect(omni_ref<Listener>(thrower), [](Listener&, int& value) {
+        if (value < 0)
+            throw std::runtime_error("negative");
+    });
+    changed.connect<&Listener::add>(omni_ref<Listener>(after));
+
+    expired.reset();
+
+    REQUIRE_THROWS_AS(changed.emit(-1), std::runtime_error);
+    REQUIRE(changed.size() == 2);
+    REQUIRE(after->total == 0);
+
+    changed.emit(4);
+    REQUIRE(after->total == 4);
+}
@@ -0,0 +1,138 @@
+#include "OmniSpan.hpp"
+#include "Common.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <ranges>
+
+using namespace DxPtr;
+
+static_assert(std::ranges::contiguous_range<omni_span<int>>);
+static_assert(std::ranges::contiguous_range<omni_span<const float>>);
+
+TEST_CASE("Array owners know their size", "[span][size]") {
+    auto array = make_omni<int[]>(12);
+    REQUIRE(array.size() == 12);
+
+    omni_ptr<int[]> adopted(new int[4]);
+    REQUIRE(adopted.size() == 0);
+
+    omni_ptr<int[]> empty;
+    REQUIRE(empty.size() == 0);
+}
+
+TEST_CASE("Span basic use", "[span][basic]") {
+    auto array = make_omni<int[]>(10);
+    std::iota(&array[0], &array[0] + 10, 0);
+
+    omni_span<int> all = array;
+    omni_span<const int> middle = all.subspan(3, 4);
+
+    REQUIRE(all.size() == 10);
+    REQUIRE(middle.size() == 4);
+    REQUIRE(middle.front() == 3);
+    REQUIRE(middle.back() == 6);
+    REQUIRE(std::accumulate(middle.begin(), middle.end(), 0) == 18);
+    REQUIRE(std::ranges::equal(all.last_n(2), std::array{ 8, 9 }));
+    REQUIRE(array.use_count() == 3);
+
+    std::ranges::fill(all.first_n(3), -1);
+    REQUIRE(array[2] == -1);
+
+    // Tight loops take a plain std::span once
+    int sum = 0;
+
+    for (int value : middle.span())
+        sum += value;
+
+    REQUIRE(sum == 18);
+
+    array.reset();
+
+    REQUIRE(all.expired());
+    REQUIRE(middle.expired());
+    REQUIRE(middle.data() == nullptr);
+    REQUIRE(middle.span().empty());
+    REQUIRE(middle.use_count() == 2);
+}
+
+TEST_CASE("Span bounds", "[span][errors]") {
+    auto array = make_omni<int[]>(8);
+    omni_span<int> all = array;
+
+    REQUIRE_THROWS_AS(all.subspan(9), std::out_of_range);
+    REQUIRE_THROWS_AS(all.subspan(4, 5), std::out_of_range);
+    REQUIRE(all.subspan(8).empty());
+
+    REQUIRE_THROWS_AS(omni_span<int>(array, 9), std::out_of_range);
+
+    // Adopted arrays have no size to check against, so they need a count
+    omni_ptr<int[]> adopted(new int[4]{ 1, 2, 3, 4 });
+
+    REQUIRE_THROWS_AS(omni_span<int>(adopted), std::invalid_argument);
+    REQUIRE(omni_span(adopted, 4).back() == 4);
+
+    // An empty array made with make_omni has a known size of zero
+    auto none = make_omni<int[]>(0);
+    omni_span<int> nothing = none;
+
+    REQUIRE(nothing.empty());
+    REQUIRE_FALSE(nothing.expired());
+    REQUIRE_THROWS_AS(omni_span<int>(none, 1), std::out_of_range);
+}
+
+TEST_CASE("Extents", "[span][mdspan]") {
+    omni_extents<std::dynamic_extent, 4> mixed(3);
+
+    static_assert(decltype(mixed)::rank() == 2);
+    static_assert(decltype(mixed)::rank_dynamic() == 1);
+
+    REQUIRE(mixed.extent(0) == 3);
+    REQUIRE(mixed.extent(1) == 4);
+    REQUIRE(mixed.size() == 12);
+    REQUIRE(mixed == omni_extents<std::dynamic_extent, 4>(3, 4));
+
+    REQUIRE_THROWS_AS((omni_extents<std::dynamic_extent, 4>(3, 5)), std::invalid_argument);
+}
+
+TEST_CASE("Mdspan layouts and tiles", "[span][mdspan]") {
+    auto array = make_omni<float[]>(6 * 8);
+    std::iota(&array[0], &array[0] + 48, 0.0f);
+
+    omni_span<float> elements = array;
+    omni_mdspan<float, omni_dextents<2>> matrix(elements, omni_dextents<2>(6, 8));
+
+    REQUIRE(matrix.extent(0) == 6);
+    REQUIRE(matrix(2, 3) == 19.0f);
+    REQUIRE(matrix.stride(0) == 8);
+    REQUIRE(matrix.is_exhaustive());
+
+    omni_mdspan<const float, omni_dextents<2>, layout_left> columns(elements, omni_dextents<2>(8, 6));
+    REQUIRE(columns(3, 2) == 19.0f);
+
+    // A 2x3 tile starting at row 1, column 4
+    auto tile = matrix.tile({ 1, 4 }, { 2, 3 });
+
+    REQUIRE(tile.extent(0) == 2);
+    REQUIRE(tile.extent(1) == 3);
+    REQUIRE(tile(0, 0) == 12.0f);
+    REQUIRE(tile(1, 2) == 22.0f);
+    REQUIRE(not tile.is_exhaustive());
+    REQUIRE_THROWS_AS(tile.flat(), std::logic_error);
+    REQUIRE_THROWS_AS(matrix.tile({ 5, 0 }, { 2, 1 }), std::out_of_range);
+
+    tile(1, 1) = -1.0f;
+    REQUIRE(array[2 * 8 + 5] == -1.0f);
+
+    omni_mdspan<const float, omni_dextents<2>, layout_stride> readOnly = tile;
+    REQUIRE(readOnly(1, 1) == -1.0f);
+
+    REQUIRE(matrix.flat().size() == 48);
+    REQUIRE_THROWS_AS((omni_mdspan<float, omni_extents<7, 7>>(elements, omni_extents<7, 7>())), std::out_of_range);
+
+    array.reset();
+
+    REQUIRE(tile.expired());
+    REQUIRE(readOnly.data_handle() == nullptr);
+    REQUIRE(matrix.expired());
+}
@@ -0,0 +1,180 @@
+#include "OmniSpill.hpp"
+#include "Common.hpp"
+
+#include <numeric>
+#include <thread>
+#include <vector>
+
+using namespace DxPtr;
+
+namespace {
+    struct Histogram {
+        std::uint32_t bins[2048];
+    };
+
+    // Serialized through its own spill and unspill
+    struct Document {
+        static inline int alive = 0;
+
+        std::string title;
+        std::vector<int> words;
+
+        Document(std::string title, std::vector<int> words) : title(std::move(title)), words(std::move(words)) {
+            alive++;
+        }
+
+        Document(Document&& move) noexcept : title(std::move(move.title)), words(std::move(move.words)) {
+            alive++;
+        }
+
+        ~Document() {
+            alive--;
+        }
+
+        void spill(std::ostream& out) const {
+            std::size_t count = words.size();
+
+            out << title << '\n';
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            out.write(reinterpret_cast<const char*>(words.data()), static_cast<std::streamsize>(count * sizeof(int)));
+        }
+
+        static Document unspill(std::istream& in) {
+            std::string title;
+            std::size_t count;
+
+            std::getline(in, title);
+            in.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+            std::vector<int> words(count);
+            in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(count * sizeof(int)));
+
+            return Document(std::move(title), std::move(words));
+        }
+    };
+}
+
+template<>
+inline constexpr bool DxPtr::lazy_construction<Histogram> = true;
+
+template<>
+inline constexpr bool DxPtr::lazy_construction<Document> = true;
+
+// Spillables hand out views, but cannot be moved into an owner that would skip rehydration
+static_assert(not std::constructible_from<omni_ptr<Histogram>, omni_spillable<Histogram>&&>);
+static_assert(std::convertible_to<const omni_spillable<Histogram>&, omni_view<Histogram>>);
+static_assert(std::convertible_to<const omni_spillable<Histogram>&, omni_ref<Histogram>>);
+
+TEST_CASE("Spilling trivially copyable objects", "[spill][basic]") {
+    omni_spill_file file;
+
+    auto histogram = make_omni_spillable<Histogram>(file);
+    std::iota(std::begin(histogram->bins), std::end(histogram->bins), 0u);
+
+    omni_view<Histogram> view = histogram;
+    const Histogram* address = view.get();
+
+    REQUIRE(histogram.spill() == sizeof(Histogram));
+    REQUIRE(not histogram.is_resident());
+    REQUIRE(histogram.spill() == 0);
+    REQUIRE(file.spill_count() == 1);
+    REQUIRE(file.spilled_bytes() == sizeof(Histogram));
+
+    // Views stay valid and rehydrate at the same address
+    REQUIRE(histogram.use_count() == 2);
+    REQUIRE(not view.expired());
+    REQUIRE(view->bins[2047] == 2047);
+    REQUIRE(view.get() == address);
+    REQUIRE(histogram.is_resident());
+    REQUIRE(file.load_count() == 1);
+    REQUIRE(file.spilled_bytes() == 0);
+
+    // Spilling again reuses the same extent
+    histogram->bins[0] = 42;
+    histogram.spill();
+    histogram.load();
+
+    REQUIRE(histogram->bins[0] == 42);
+    REQUIRE(file.file_size() == sizeof(Histogram));
+
+    histogram.reset();
+    REQUIRE(view.expired());
+}
+
+TEST_CASE("Spilling serialized objects", "[spill][serialize]") {
+    Document::alive = 0;
+    omni_spill_file file;
+
+    {
+        auto document = make_omni_spillable<Document>(file, "notes", std::vector<int>{ 1, 2, 3 });
+        omni_ref<Document> ref = document;
+
+        REQUIRE(Document::alive == 1);
+        REQUIRE(document.spill() > 0);
+        REQUIRE(Document::alive == 0);
+
+        ref->words.push_back(4);
+
+        REQUIRE(Document::alive == 1);
+        REQUIRE(document->title == "notes");
+        REQUIRE(document->words == std::vector<int>{ 1, 2, 3, 4 });
+
+        // Growing past its old extent moves the object to a new one
+        document->words.resize(1000, 7);
+        document.spill();
+
+        REQUIRE(file.file_size() > 1000 * sizeof(int));
+
+        // Destroying a spilled object does not read it back
+        document.reset();
+
+        REQUIRE(ref.expired());
+        REQUIRE(file.load_count() == 1);
+        REQUIRE(file.spilled_bytes() == 0);
+    }
+
+    REQUIRE(Document::alive == 0);
+
+    omni_spillable<Document> empty;
+    REQUIRE(empty.spill() == 0);
+    REQUIRE(not empty.is_resident());
+}
+
+TEST_CASE("Spilled objects outlive their file handle", "[spill][lifetime]") {
+    omni_spillable<Histogram> histogram;
+
+    {
+        omni_spill_file file;
+        histogram = make_omni_spillable<Histogram>(file);
+        histogram->bins[5] = 5;
+        histogram.spill();
+    }
+
+    REQUIRE(histogram->bins[5] == 5);
+
+    REQUIRE_THROWS_AS(omni_spill_file("/nonexistent/omni/spill"), std::system_error);
+}
+
+TEST_CASE("Concurrent rehydration", "[spill][threads]") {
+    omni_spill_file file;
+
+    auto histogram = make_omni_spillable<Histogram>(file);
+    histogram->bins[100] = 100;
+    histogram.spill();
+
+    std::vector<std::thread> threads;
+    std::atomic<int> correct = 0;
+
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&, view = omni_view<Histogram>(histogram)] {
+            if (view->bins[100] == 100)
+                correct++;
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    REQUIRE(correct == 4);
+    REQUIRE(file.load_count() == 1);
+}
@@ -0,0 +1,127 @@
+#include "DxPtr.hpp"
+#include "Common.hpp"
+
+#include <thread>
+
+using namespace DxPtr;
+
+struct ListNode {
+    int* destroyedCount;
+    omni_ptr<ListNode> next;
+
+    ListNode(int& destroyedCount) : destroyedCount(&destroyedCount) { }
+
+    ~ListNode() {
+        (*destroyedCount)++;
+    }
+};
+
+template<>
+inline constexpr bool DxPtr::iterative_teardown<ListNode> = true;
+
+static omni_ptr<ListNode> make_list(int length, int& destroyedCount) {
+    auto head = make_omni<ListNode>(destroyedCount);
+    ListNode* tail = head.get();
+
+    for (int i = 1; i < length; i++) {
+        tail->next = make_omni<ListNode>(destroyedCount);
+        tail = tail->next.get();
+    }
+
+    return head;
+}
+
+TEST_CASE("Iterative teardown of deep lists", "[teardown][basic]") {
+    constexpr int length = 1'000'000;
+    int destroyedCount = 0;
+
+    auto head = make_list(length, destroyedCount);
+    omni_view<ListNode> second = head->next;
+
+    // Recursive destruction this deep would overflow the stack
+    head.reset();
+
+    REQUIRE(destroyedCount == length);
+    REQUIRE(second.expired());
+    REQUIRE(omni_teardown::pending() == 0);
+}
+
+TEST_CASE("Teardown spread over several steps", "[teardown][budget]") {
+    constexpr int length = 100;
+    int destroyedCount = 0;
+
+    auto head = make_list(length, destroyedCount);
+    omni_view<ListNode> first = head;
+    omni_view<ListNode> last = head;
+
+    while (last->next)
+        last = last->next;
+
+    {
+        omni_teardown deferred;
+
+        head.reset();
+
+        REQUIRE(destroyedCount == 0);
+        REQUIRE(first.expired());
+        REQUIRE(not last.expired());
+        REQUIRE(omni_teardown::pending() == 1);
+
+        REQUIRE(omni_teardown::step(10) == 10);
+        REQUIRE(destroyedCount == 10);
+        REQUIRE(omni_teardown::pending() == 1);
+        REQUIRE(not last.expired());
+    }
+
+    // Resets outside the deferral leave earlier queued work alone
+    int otherCount = 0;
+    make_list(5, otherCount).reset();
+
+    REQUIRE(otherCount == 5);
+    REQUIRE(destroyedCount == 10);
+
+    omni_teardown::drain();
+
+    REQUIRE(destroyedCount == length);
+    REQUIRE(last.expired());
+    REQUIRE(omni_teardown::pending() == 0);
+}
+
+TEST_CASE("Teardown is opt-in", "[teardown][basic]") {
+    TickerInfo info{};
+
+    {
+        omni_teardown deferred;
+        auto ticker = make_omni<Ticker>(info, "A");
+    }
+
+    REQUIRE(info == destroyed<>);
+    REQUIRE(omni_teardown::pending() == 0);
+}
+
+TEST_CASE("Teardown left pending at thread exit", "[teardown][threads]") {
+    constexpr int length = 100;
+    int destroyedCount = 0;
+    std::size_t pendingAtExit = 0;
+    omni_view<ListNode> last;
+
+    std::thread([&] {
+        auto head = make_list(length, destroyedCount);
+        last = head;
+
+        while (last->next)
+            last = last->next;
+
+        omni_teardown deferred;
+
+        head.reset();
+        omni_teardown::step(1);
+
+        // Only the second node is queued now, the rest is queued as teardown reaches it
+        pendingAtExit = omni_teardown::pending();
+    }).join();
+
+    REQUIRE(pendingAtExit == 1);
+    REQUIRE(destroyedCount == length);
+    REQUIRE(last.expired());
+}
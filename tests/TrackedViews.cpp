@@ -0,0 +1,137 @@
+#include "OmniTracked.hpp"
+#include "Common.hpp"
+
+using namespace DxPtr;
+
+TEST_CASE("Tracked owner lifetime", "[tracked][basic]") {
+    TickerInfo info{};
+
+    SECTION("Created via make_omni_tracked") {
+        auto owner = make_omni_tracked<Ticker>(info, "A");
+
+        REQUIRE(info == constructed<>);
+        REQUIRE(owner.use_count() == 1);
+        REQUIRE(owner->str == "A");
+    }
+
+    SECTION("Created via constructor") {
+        omni_tracked_ptr<Ticker> owner(new Ticker(info, "B"));
+
+        REQUIRE(info == constructed<>);
+        REQUIRE(owner->str == "B");
+    }
+
+    SECTION("Moved owner") {
+        auto owner = make_omni_tracked<Ticker>(info, "C");
+        omni_tracked_view<Ticker> view = owner;
+
+        auto moved = std::move(owner);
+
+        REQUIRE(not owner);
+        REQUIRE(moved);
+        REQUIRE(view.get() == moved.get());
+    }
+
+    REQUIRE(info == destroyed<>);
+}
+
+TEMPLATE_PRODUCT_TEST_CASE("Tracked views are severed on reset", "[tracked][ownership]", (omni_tracked_view, omni_tracked_ref), (Ticker)) {
+    using weak_t = TestType;
+    TickerInfo info{};
+
+    auto owner = make_omni_tracked<Ticker>(info, "A");
+    Ticker* ptr = owner.get();
+
+    SECTION("Single view") {
+        weak_t weak = owner;
+
+        REQUIRE(weak.get() == ptr);
+        REQUIRE(owner.use_count() == 2);
+
+        owner.reset();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(weak.expired());
+        REQUIRE(weak.get() == nullptr);
+        REQUIRE(weak.use_count() == 0);
+    }
+
+    SECTION("Copies and moves") {
+        weak_t a = owner;
+        weak_t b = a;
+        weak_t c = std::move(b);
+        weak_t d;
+        d = c;
+
+        REQUIRE(b.expired());
+        REQUIRE(owner.use_count() == 4);
+
+        {
+            weak_t e = a;
+            REQUIRE(owner.use_count() == 5);
+        }
+
+        REQUIRE(owner.use_count() == 4);
+
+        owner.reset();
+
+        REQUIRE(info == destroyed<>);
+        REQUIRE(a.get() == nullptr);
+        REQUIRE(c.get() == nullptr);
+        REQUIRE(d.get() == nullptr);
+    }
+
+    SECTION("Views destroyed first") {
+        {
+            weak_t a = owner;
+            weak_t b = owner;
+
+            REQUIRE(owner.use_count() == 3);
+        }
+
+        REQUIRE(owner.use_count() == 1);
+
+        owner.reset();
+
+        REQUIRE(info == destroyed<>);
+    }
+
+    SECTION("Reassigned view") {
+        TickerInfo otherInfo{};
+        auto other = make_omni_tracked<Ticker>(otherInfo, "B");
+
+        weak_t weak = owner;
+        weak = other;
+
+        REQUIRE(owner.use_count() == 1);
+        REQUIRE(other.use_count() == 2);
+
+        other.reset();
+
+        REQUIRE(weak.expired());
+        REQUIRE(otherInfo == destroyed<>);
+        REQUIRE(info == constructed<>);
+    }
+}
+
+TEST_CASE("Tracked view conversions", "[tracked][inheritance]") {
+    TickerInfo baseInfo{}, derivedInfo{};
+
+    auto owner = make_omni_tracked<Derived>(derivedInfo, baseInfo);
+    omni_tracked_ref<Derived> derived = owner;
+    omni_tracked_view<Base> base = derived;
+
+    std::string out;
+    base->Write(out);
+
+    REQUIRE(out == "BaseDerived");
+    REQUIRE(base.get() == static_cast<Base*>(owner.get()));
+    REQUIRE(owner.use_count() == 3);
+
+    owner.reset();
+
+    REQUIRE(derived.expired());
+    REQUIRE(base.expired());
+    REQUIRE(baseInfo == destroyed<>);
+    REQUIRE(derivedInfo == destroyed<>);
+}
@@ -0,0 +1,79 @@
+#include "OmniTrailing.hpp"
+#include "Common.hpp"
+
+#include <numeric>
+
+using namespace DxPtr;
+
+struct PacketHeader {
+    int id;
+    std::size_t length;
+};
+
+struct alignas(32) WideElement {
+    double lanes[4] = {};
+};
+
+TEST_CASE("Trailing payload basic use", "[trailing][basic]") {
+    auto packet = make_omni_trailing<PacketHeader, int>(8, PacketHeader{ 7, 8 });
+    omni_view<PacketHeader> view = packet;
+
+    REQUIRE(packet->id == 7);
+    REQUIRE(view->length == 8);
+    REQUIRE(packet.trailing().size() == 8);
+
+    for (int value : packet.trailing())
+        REQUIRE(value == 0);
+
+    std::iota(packet.trailing().begin(), packet.trailing().end(), 1);
+
+    REQUIRE(std::accumulate(packet.trailing().begin(), packet.trailing().end(), 0) == 36);
+
+    // Header and elements sit in the same buffer, right after the header
+    auto* headerEnd = reinterpret_cast<const std::byte*>(packet.get() + 1);
+    auto* elements = reinterpret_cast<const std::byte*>(packet.trailing().data());
+
+    REQUIRE(elements >= headerEnd);
+    REQUIRE(elements - headerEnd < static_cast<std::ptrdiff_t>(alignof(int)));
+
+    packet.reset();
+
+    REQUIRE(view.expired());
+    REQUIRE(packet.trailing().empty());
+}
+
+TEST_CASE("Trailing payload destroys every element", "[trailing][lifetime]") {
+    TickerInfo headerInfo{}, elementInfo{};
+
+    struct Element {
+        omni_ptr<Ticker> ticker;
+    };
+
+    {
+        auto owner = make_omni_trailing<Ticker, Element>(5, headerInfo, "header");
+
+        for (auto& element : owner.trailing())
+            element.ticker = make_omni<Ticker>(elementInfo, "element");
+
+        REQUIRE(elementInfo.constructed == 5);
+        REQUIRE(owner->str == "header");
+    }
+
+    REQUIRE(headerInfo == destroyed<>);
+    REQUIRE(elementInfo == destroyed<5>);
+}
+
+TEST_CASE("Trailing payload alignment", "[trailing][alignment]") {
+    auto owner = make_omni_trailing<char, WideElement>(3, 'x');
+
+    REQUIRE(*owner == 'x');
+    REQUIRE(reinterpret_cast<std::uintptr_t>(owner.trailing().data()) % alignof(WideElement) == 0);
+    REQUIRE(owner.trailing()[2].lanes[3] == 0.0);
+}
+
+TEST_CASE("Trailing payload without elements", "[trailing][basic]") {
+    auto owner = make_omni_trailing<PacketHeader, int>(0, PacketHeader{ 1, 0 });
+
+    REQUIRE(owner->id == 1);
+    REQUIRE(owner.trailing().empty());
+}
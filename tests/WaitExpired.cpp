@@ -0,0 +1,66 @@
+#include "DxPtr.hpp"
+#include "Common.hpp"
+
+#include <chrono>
+#include <thread>
+
+using namespace DxPtr;
+using namespace std::chrono_literals;
+
+TEMPLATE_PRODUCT_TEST_CASE("Waiting for expiry", "[wait][threads]", (omni_view, omni_ref), (int)) {
+    using weak_t = TestType;
+
+    SECTION("Already expired returns immediately") {
+        weak_t empty;
+        weak_t dropped;
+
+        {
+            auto owner = make_omni<int>(1);
+            dropped = owner;
+        }
+
+        empty.wait_expired();
+        dropped.wait_expired();
+
+        REQUIRE(empty.wait_expired_for(0s));
+        REQUIRE(dropped.wait_expired_for(0s));
+    }
+
+    SECTION("Timed wait times out while the owner lives") {
+        auto owner = make_omni<int>(1);
+        weak_t view = owner;
+
+        REQUIRE(not view.wait_expired_for(5ms));
+        REQUIRE(not view.expired());
+    }
+
+    SECTION("Wakes when another thread resets the owner") {
+        auto owner = make_omni<int>(1);
+        weak_t view = owner;
+
+        std::thread releaser([owner = std::move(owner)]() mutable {
+            std::this_thread::sleep_for(10ms);
+            owner.reset();
+        });
+
+        view.wait_expired();
+
+        REQUIRE(view.expired());
+
+        releaser.join();
+    }
+
+    SECTION("Timed wait wakes before the timeout") {
+        auto owner = make_omni<int>(1);
+        weak_t view = owner;
+
+        std::thread releaser([owner = std::move(owner)]() mutable {
+            std::this_thread::sleep_for(5ms);
+            owner.reset();
+        });
+
+        REQUIRE(view.wait_expired_for(10s));
+
+        releaser.join();
+    }
+}
@@ -0,0 +1,197 @@
+#include "OmniWeakMap.hpp"
+#include "Common.hpp"
+
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace DxPtr;
+
+TEST_CASE("Owner identity", "[weakmap][owner]") {
+    auto first = make_omni<int>(1);
+    auto second = make_omni<int>(1);
+
+    omni_view<int> firstView = first;
+    omni_ref<int> firstRef = first;
+    omni_view<int> secondView = second;
+
+    REQUIRE(first.owner_equal(firstView));
+    REQUIRE(firstRef.owner_equal(firstView));
+    REQUIRE(not firstView.owner_equal(secondView));
+    REQUIRE(firstView.owner_hash() == first.owner_hash());
+    REQUIRE(first.owner_before(second) != second.owner_before(first));
+
+    first.reset();
+    second.reset();
+
+    // Both views are now null, so == cannot tell them apart, but their owners stay distinct
+    REQUIRE(firstView == secondView);
+    REQUIRE(not firstView.owner_equal(secondView));
+    REQUIRE(omni_owner_equal{}(firstView, firstRef));
+
+    std::map<omni_view<int>, std::string, omni_owner_less> names;
+    names[firstView] = "first";
+    names[secondView] = "second";
+
+    REQUIRE(names.size() == 2);
+    REQUIRE(names.find(firstRef)->second == "first");
+
+    std::unordered_set<omni_view<int>, omni_owner_hash, omni_owner_equal> seen{ firstView, secondView, firstRef };
+    REQUIRE(seen.size() == 2);
+}
+
+TEST_CASE("Weak map basic use", "[weakmap][basic]") {
+    omni_weak_map<std::string, std::string> labels;
+
+    auto a = make_omni<std::string>("a");
+    auto b = make_omni<std::string>("b");
+    omni_view<std::string> aView = a;
+
+    labels[a] = "a";
+    REQUIRE(labels.try_emplace(b, "b").second);
+    REQUIRE(not labels.try_emplace(aView, "again").second);
+    REQUIRE(labels.insert_or_assign(b, "bee").first == labels.find(b));
+
+    REQUIRE(labels.size() == 2);
+    REQUIRE(*labels.find(aView) == "a");
+    REQUIRE(*labels.find(b) == "bee");
+    REQUIRE(labels.contains(a));
+
+    // The map never keeps its keys alive
+    REQUIRE(a.use_count() == 3);
+
+    a.reset();
+
+    REQUIRE(not labels.contains(aView));
+    REQUIRE(labels.size() == 2);
+    REQUIRE(labels.find(aView) == nullptr);
+    REQUIRE(labels.size() == 1);
+
+    REQUIRE(labels.erase(b));
+    REQUIRE(not labels.erase(b));
+    REQUIRE(labels.empty());
+
+    REQUIRE_THROWS_AS(labels[omni_view<std::string>()], std::invalid_argument);
+    REQUIRE_THROWS_AS(labels[aView], std::invalid_argument);
+    REQUIRE(labels.find(omni_ptr<std::string>()) == nullptr);
+}
+
+TEST_CASE("Weak map purging", "[weakmap][purge]") {
+    SECTION("Incremental") {
+        omni_weak_map<int, int> values;
+        std::vector<omni_ptr<int>> owners;
+
+        for (int i = 0; i < 10; i++) {
+            owners.push_back(make_omni<int>(i));
+            values[owners.back()] = i * 10;
+        }
+
+        auto live = make_omni<int>(-1);
+        values[live] = -1;
+
+        std::size_t capacity = values.capacity();
+        owners.clear();
+
+        REQUIRE(values.size() == 11);
+
+        // Every access sweeps a couple of slots, so touching the map a capacity's worth reclaims the dead
+        for (std::size_t i = 0; i < capacity; i++)
+            values[live]++;
+
+        REQUIRE(values.size() == 1);
+        REQUIRE(values.capacity() == capacity);
+        REQUIRE(*values.find(live) == static_cast<int>(capacity) - 1);
+
+        // Churn through short-lived keys never grows the table
+        for (int round = 0; round < 1000; round++) {
+            auto temporary = make_omni<int>(round);
+            values[temporary] = round;
+        }
+
+        REQUIRE(values.capacity() == capacity);
+    }
+
+    SECTION("Explicit") {
+        omni_weak_map<int, int> values(0);
+        std::vector<omni_ptr<int>> owners;
+
+        for (int i = 0; i < 40; i++) {
+            owners.push_back(make_omni<int>(i));
+            values[owners.back()] = i;
+        }
+
+        for (std::size_t i = 0; i < owners.size(); i += 2)
+            owners[i].reset();
+
+        REQUIRE(values.size() == 40);
+
+        std::size_t dropped = values.purge_some(values.capacity() / 2);
+        dropped += values.purge();
+
+        REQUIRE(dropped == 20);
+        REQUIRE(values.size() == 20);
+
+        // Backward shifts must keep every survivor reachable
+        for (std::size_t i = 1; i < owners.size(); i += 2)
+            REQUIRE(*values.find(owners[i]) == static_cast<int>(i));
+
+        int visited = 0;
+        values.for_each([&](const omni_view<int>& key, int& value) {
+            REQUIRE(*key == value);
+            visited++;
+        });
+
+        REQUIRE(visited == 20);
+
+        values.clear();
+        REQUIRE(values.empty());
+    }
+
+    SECTION("Runs wrapping around the end of the table") {
+        omni_weak_map<int, int> values(0);
+        std::vector<omni_ptr<int>> owners;
+        std::mt19937 random(7);
+
+        // A full sweep must leave no dead entries, wherever their runs start
+        for (int round = 0; round < 200; round++) {
+            while (owners.size() < 11) {
+                owners.push_back(make_omni<int>(round));
+                values[owners.back()] = round;
+            }
+
+            std::erase_if(owners, [&](const omni_ptr<int>&) { return random() % 2 == 0; });
+
+            values.purge();
+
+            REQUIRE(values.size() == owners.size());
+            REQUIRE(values.capacity() == 16);
+
+            for (const auto& owner : owners)
+                REQUIRE(values.find(owner) != nullptr);
+        }
+    }
+}
+
+TEST_CASE("Weak map values are destroyed", "[weakmap][lifetime]") {
+    TickerInfo info;
+
+    {
+        omni_weak_map<int, Ticker> tickers;
+        std::vector<omni_ptr<int>> owners;
+
+        for (int i = 0; i < 100; i++) {
+            owners.push_back(make_omni<int>(i));
+            tickers.try_emplace(owners.back(), info, "value");
+        }
+
+        owners.resize(50);
+        tickers.purge();
+
+        REQUIRE(tickers.size() == 50);
+    }
+
+    REQUIRE(info.constructed == 100);
+    REQUIRE(info.constructed + info.copyConstructed + info.moveConstructed == info.destroyed);
+}
@@ -0,0 +1,178 @@
+# Checks the disassembly of an object file against the codegen budgets in its source.
+#
+#   cmake -DOBJDUMP=<objdump> -DOBJECT=<object file> -DSOURCE=<source file>
+#         [-DCOMPILER=<compiler id>] -P CheckCodegen.cmake
+#
+# Budgets are comments in the source of the form
+#   // codegen: <symbol> max_instructions=N max_calls=N [no_indirect_calls] [forbid=<text>]...
+# Calls count direct, indirect and tail calls. Alignment padding is not counted.
+# A budget written as max_instructions[<compiler id>]=N applies only when COMPILER
+# matches, and takes precedence over an unqualified one.
+
+cmake_minimum_required(VERSION 3.20)
+
+foreach(var OBJDUMP OBJECT SOURCE)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "CheckCodegen.cmake needs -D${var}=...")
+  endif()
+endforeach()
+
+execute_process(
+  COMMAND ${OBJDUMP} -d -r -C --no-show-raw-insn ${OBJECT}
+  OUTPUT_VARIABLE disassembly
+  ERROR_VARIABLE errors
+  RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${OBJDUMP} failed on ${OBJECT}:\n${errors}")
+endif()
+
+file(STRINGS ${SOURCE} expectations REGEX "^// codegen: ")
+
+set(tracked "")
+
+foreach(expectation IN LISTS expectations)
+  if(NOT expectation MATCHES "^// codegen: ([A-Za-z0-9_]+)")
+    message(FATAL_ERROR "Malformed codegen comment: ${expectation}")
+  endif()
+
+  list(APPEND tracked ${CMAKE_MATCH_1})
+endforeach()
+
+# Brackets and semicolons would split lines apart as CMake lists
+string(REPLACE ";" "," disassembly "${disassembly}")
+string(REPLACE "[" "(" disassembly "${disassembly}")
+string(REPLACE "]" ")" disassembly "${disassembly}")
+string(REPLACE "\n" ";" lines "${disassembly}")
+
+set(prefixes lock rep repz repnz repe repne notrack bnd data16 cs ds es ss)
+
+set(current "")
+set(pendingJump OFF)
+
+foreach(line IN LISTS lines)
+  if(line MATCHES "^[0-9a-f]+ <(.+)>:$")
+    set(current "")
+    set(pendingJump OFF)
+
+    if(CMAKE_MATCH_1 IN_LIST tracked)
+      set(current ${CMAKE_MATCH_1})
+      set(found_${current} ON)
+      set(instructions_${current} 0)
+      set(calls_${current} 0)
+      set(indirect_${current} 0)
+      set(text_${current} "")
+    endif()
+
+    continue()
+  endif()
+
+  if(current STREQUAL "")
+    continue()
+  endif()
+
+  # Relocations name the symbols instructions refer to. One on a jump makes it a tail call.
+  if(line MATCHES "^[ \t]+[0-9a-f]+: R_")
+    string(APPEND text_${current} "${line}\n")
+
+    if(pendingJump)
+      math(EXPR calls_${current} "${calls_${current}} + 1")
+      set(pendingJump OFF)
+    endif()
+
+    continue()
+  endif()
+
+  if(NOT line MATCHES "^[ \t]*[0-9a-f]+:\t(.*)$")
+    continue()
+  endif()
+
+  set(instruction "${CMAKE_MATCH_1}")
+  set(pendingJump OFF)
+  string(APPEND text_${current} "${line}\n")
+
+  if(instruction MATCHES "nop|^xchg +%ax,%ax|^int3")
+    continue()
+  endif()
+
+  math(EXPR instructions_${current} "${instructions_${current}} + 1")
+
+  # Mnemonic and operands, past any prefixes
+  string(REGEX MATCHALL "[^ \t]+" words "${instruction}")
+  list(POP_FRONT words mnemonic)
+
+  while(mnemonic IN_LIST prefixes AND words)
+    list(POP_FRONT words mnemonic)
+  endwhile()
+
+  set(operands "")
+
+  if(words)
+    list(GET words 0 operands)
+  endif()
+
+  if(mnemonic MATCHES "^(call|callq|bl|blx|blr|blraa|blrab)$")
+    math(EXPR calls_${current} "${calls_${current}} + 1")
+
+    if(operands MATCHES "^\\*" OR mnemonic MATCHES "^blr")
+      math(EXPR indirect_${current} "${indirect_${current}} + 1")
+    endif()
+  elseif(mnemonic MATCHES "^(jmp|jmpq|br)$" AND (operands MATCHES "^\\*" OR mnemonic STREQUAL "br"))
+    math(EXPR calls_${current} "${calls_${current}} + 1")
+    math(EXPR indirect_${current} "${indirect_${current}} + 1")
+  elseif(mnemonic MATCHES "^(j[a-z]+|b|b\\.[a-z]+|cbn?z|tbn?z)$")
+    set(pendingJump ON)
+  endif()
+endforeach()
+
+set(failures "")
+
+foreach(expectation IN LISTS expectations)
+  string(REGEX MATCH "^// codegen: ([A-Za-z0-9_]+)" _ "${expectation}")
+  set(symbol ${CMAKE_MATCH_1})
+
+  if(NOT found_${symbol})
+    string(APPEND failures "${symbol}: not found in ${OBJECT}\n")
+    continue()
+  endif()
+
+  message(STATUS "${symbol}: ${instructions_${symbol}} instructions, ${calls_${symbol}} calls, ${indirect_${symbol}} indirect")
+
+  foreach(budget instructions calls)
+    set(limit "")
+
+    if(DEFINED COMPILER AND expectation MATCHES "max_${budget}\\[${COMPILER}\\]=([0-9]+)")
+      set(limit ${CMAKE_MATCH_1})
+    elseif(expectation MATCHES "max_${budget}=([0-9]+)")
+      set(limit ${CMAKE_MATCH_1})
+    endif()
+
+    if(NOT limit STREQUAL "" AND ${budget}_${symbol} GREATER limit)
+      string(APPEND failures "${symbol}: ${${budget}_${symbol}} ${budget}, budget is ${limit}\n")
+    endif()
+  endforeach()
+
+  if(expectation MATCHES "no_indirect_calls" AND indirect_${symbol} GREATER 0)
+    string(APPEND failures "${symbol}: ${indirect_${symbol}} indirect calls\n")
+  endif()
+
+  string(REGEX MATCHALL "forbid=[^ \t]+" forbidden "${expectation}")
+
+  foreach(entry IN LISTS forbidden)
+    string(SUBSTRING "${entry}" 7 -1 text)
+    string(FIND "${text_${symbol}}" "${text}" position)
+
+    if(NOT position EQUAL -1)
+      string(APPEND failures "${symbol}: refers to forbidden '${text}'\n")
+    endif()
+  endforeach()
+
+  if(failures MATCHES "(^|\n)${symbol}: ")
+    message(STATUS "Disassembly of ${symbol}:\n${text_${symbol}}")
+  endif()
+endforeach()
+
+if(NOT failures STREQUAL "")
+  message(FATAL_ERROR "Codegen budgets exceeded:\n${failures}")
+endif()
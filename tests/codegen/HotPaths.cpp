@@ -0,0 +1,71 @@
+// Hot paths compiled on their own at -O2 and disassembled by CheckCodegen.cmake.
+// Each function is checked against the budget in the codegen comment above it:
+//   max_instructions  instructions in the function, alignment padding excluded
+//   max_calls         direct, indirect and tail calls
+//   no_indirect_calls virtual or other calls through a pointer
+//   forbid=<text>     text that must not appear in the disassembly or its relocations
+//
+// A budget written as max_instructions[<compiler id>]=N only applies to that compiler,
+// as CMAKE_CXX_COMPILER_ID names it, and replaces the unqualified one. Qualified budgets
+// sit close to the counts measured with that compiler. Unqualified ones leave headroom
+// for the inlining choices of other compilers.
+//
+// This file is only compiled, never linked, so declared-only functions are fine.
+
+#include "DxPtr.hpp"
+
+using namespace DxPtr;
+
+// Out of line so its destructor shows up as exactly one call
+struct CodegenResource {
+    int handle;
+    ~CodegenResource();
+};
+
+using int_block = detail::omni_block<int, true>;
+using resource_block = detail::omni_block<CodegenResource, true>;
+using resource_array_block = detail::omni_block<CodegenResource[], true>;
+
+// codegen: codegen_view_get max_instructions=14 max_instructions[GNU]=11 max_calls=0
+extern "C" const int* codegen_view_get(const omni_view<int>& view) {
+    return view.get();
+}
+
+// codegen: codegen_view_copy max_instructions=28 max_instructions[GNU]=24 max_calls=0
+extern "C" void codegen_view_copy(omni_view<int>* out, const omni_view<int>& view) {
+    ::new(out) omni_view<int>(view);
+}
+
+// codegen: codegen_owner_get max_instructions=4 max_instructions[GNU]=2 max_calls=0
+extern "C" int* codegen_owner_get(const omni_ptr<int>& owner) {
+    return owner.get();
+}
+
+// Expiring and releasing the block are virtual. Waking waiters, taking the bias from
+// another thread and freeing the thread's state once its last biased block goes are
+// out of line, everything else stays inline.
+// codegen: codegen_owner_reset max_instructions=110 max_instructions[GNU]=56 max_calls=7 max_calls[GNU]=6 forbid=cerr
+extern "C" void codegen_owner_reset(omni_ptr<int>& owner) {
+    owner.reset();
+}
+
+// codegen: codegen_array_reset max_instructions=110 max_instructions[GNU]=56 max_calls=7 max_calls[GNU]=6 forbid=cerr
+extern "C" void codegen_array_reset(omni_ptr<CodegenResource[]>& owner) {
+    owner.reset();
+}
+
+// codegen: codegen_call_deleter_trivial max_instructions=2 max_instructions[GNU]=1 max_calls=0 no_indirect_calls forbid=cerr
+extern "C" void codegen_call_deleter_trivial(int_block* block) {
+    block->int_block::call_deleter();
+}
+
+// codegen: codegen_call_deleter_resource max_instructions=4 max_instructions[GNU]=2 max_calls=1 no_indirect_calls forbid=cerr
+extern "C" void codegen_call_deleter_resource(resource_block* block) {
+    block->resource_block::call_deleter();
+}
+
+// One destructor call in a loop over the elements
+// codegen: codegen_call_deleter_resource_array max_instructions=24 max_instructions[GNU]=19 max_calls=1 no_indirect_calls forbid=cerr
+extern "C" void codegen_call_deleter_resource_array(resource_array_block* block) {
+    block->resource_array_block::call_deleter();
+}